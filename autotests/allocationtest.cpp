@@ -0,0 +1,153 @@
+#include <QtTest>
+#include <QtCore>
+
+#include "../src/l10n_language.h"
+#include "../src/l10n_languageinfo.h"
+#include "../src/l10n_locale.h"
+#include "../src/l10n_statistics.h"
+#include "../src/l10n_stringtable_p.h"
+
+#include <stdlib.h>
+
+// Interposes the glibc allocator to count heap allocations of the library,
+// including allocations made inside QtCore on its behalf.
+extern "C" {
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t count, size_t size);
+void *__libc_realloc(void *ptr, size_t size);
+}
+
+static QAtomicInt s_counting;
+static QAtomicInt s_allocations;
+
+extern "C" void *malloc(size_t size)
+{
+    if (s_counting.load())
+        s_allocations.ref();
+    return __libc_malloc(size);
+}
+
+extern "C" void *calloc(size_t count, size_t size)
+{
+    if (s_counting.load())
+        s_allocations.ref();
+    return __libc_calloc(count, size);
+}
+
+extern "C" void *realloc(void *ptr, size_t size)
+{
+    if (s_counting.load())
+        s_allocations.ref();
+    return __libc_realloc(ptr, size);
+}
+
+// Runs function twice and returns the allocations of the second run, so
+// lazily initialized statics do not count against the budget.
+template <typename Function>
+static int countAllocations(Function function)
+{
+    function();
+    s_allocations.store(0);
+    s_counting.store(1);
+    function();
+    s_counting.store(0);
+    return s_allocations.load();
+}
+
+#define QVERIFY_BUDGET(allocations, budget) \
+    do { \
+        const int actual = (allocations); \
+        if (actual > (budget)) \
+            QFAIL(qPrintable(QString::fromLatin1("%1 allocations exceed the budget of %2").arg(actual).arg(budget))); \
+    } while (false)
+
+class allocationTest : public QObject
+{
+    Q_OBJECT
+private slots:
+    void testCounting();
+    void testCodeMapping();
+    void testSystemLanguageCode();
+    void testSystemLocaleString();
+    void testSystemLanguages();
+    void testStringTable();
+    void testStatisticsSnapshot();
+    void testInvalidLanguageInfo();
+};
+
+void allocationTest::testCounting()
+{
+    // Make sure interposition actually works, otherwise everything passes.
+    QVERIFY(countAllocations([] { QString::number(1234567890).detach(); }) > 0);
+}
+
+void allocationTest::testCodeMapping()
+{
+    const QString mapped = QLatin1String("zh_TW");
+    const QString unmapped = QLatin1String("de");
+    const QString mappedPackage = QLatin1String("zhtw");
+
+    QVERIFY_BUDGET(countAllocations([&] { Kubuntu::Language::ubuntuPackageCodeForKdeCode(unmapped); }), 0);
+    QVERIFY_BUDGET(countAllocations([&] { Kubuntu::Language::ubuntuPackageCodeForKdeCode(mapped); }), 1);
+    QVERIFY_BUDGET(countAllocations([&] { Kubuntu::Language::kdePackageCodeForKdeLanguageCode(unmapped); }), 0);
+    QVERIFY_BUDGET(countAllocations([&] { Kubuntu::Language::kdePackageCodeForKdeLanguageCode(mapped); }), 1);
+    QVERIFY_BUDGET(countAllocations([&] { Kubuntu::Language::kdeLanguageCodeForKdePackageCode(unmapped); }), 0);
+    QVERIFY_BUDGET(countAllocations([&] { Kubuntu::Language::kdeLanguageCodeForKdePackageCode(mappedPackage); }), 1);
+}
+
+void allocationTest::testSystemLanguageCode()
+{
+    Kubuntu::Language language(QLatin1String("ca@valencia"));
+    QVERIFY_BUDGET(countAllocations([&] { language.systemLanguageCode(); }), 0);
+    QVERIFY_BUDGET(countAllocations([&] { language.kdePackageCode(); }), 0);
+    QVERIFY_BUDGET(countAllocations([&] { language.ubuntuPackageCode(); }), 0);
+}
+
+void allocationTest::testSystemLocaleString()
+{
+    Kubuntu::Locale locale(QList<QString>() << "ca@valencia" << "de", QLatin1String("ES"));
+    QVERIFY_BUDGET(countAllocations([&] { locale.systemLocaleString(); }), 1);
+}
+
+void allocationTest::testSystemLanguages()
+{
+    Kubuntu::Locale locale(QList<QString>() << "zh_CN" << "zh_TW" << "de" << "en_GB" << "fr",
+                           QLatin1String("US"));
+    QVERIFY_BUDGET(countAllocations([&] { locale.systemLanguages(); }), 1);
+    QVERIFY_BUDGET(countAllocations([&] { locale.systemLanguagesString(); }), 2);
+}
+
+void allocationTest::testStringTable()
+{
+    using Kubuntu::StringTable;
+    const QString prefix = QLatin1String("kde-l10n-");
+    const QString code = QLatin1String("de");
+    const quint32 prefixId = StringTable::intern(prefix);
+    const quint32 codeId = StringTable::intern(code);
+    QVERIFY_BUDGET(countAllocations([&] { StringTable::intern(prefix); }), 0);
+    QVERIFY_BUDGET(countAllocations([&] { StringTable::string(codeId); }), 0);
+    QVERIFY_BUDGET(countAllocations([&] { StringTable::packageName(prefixId, codeId); }), 0);
+}
+
+void allocationTest::testStatisticsSnapshot()
+{
+    using Kubuntu::Statistics;
+    QVERIFY_BUDGET(countAllocations([] { Statistics::snapshot().count(Statistics::PackageLookups); }), 0);
+    QVERIFY_BUDGET(countAllocations([] {
+        Statistics copy = Statistics::snapshot();
+        copy = Statistics();
+    }), 0);
+}
+
+void allocationTest::testInvalidLanguageInfo()
+{
+    QVERIFY_BUDGET(countAllocations([] {
+        Kubuntu::LanguageInfo info;
+        Kubuntu::LanguageInfo copy = info;
+        copy.isValid();
+    }), 0);
+}
+
+QTEST_MAIN(allocationTest)
+
+#include "allocationtest.moc"
@@ -0,0 +1,116 @@
+#include <QtTest>
+#include <QtCore>
+
+// Runs kubuntu-l10n-audit against fixtures and checks its exit codes.
+class auditTest : public QObject
+{
+    Q_OBJECT
+private slots:
+    void initTestCase();
+    void testExitCode_data();
+    void testExitCode();
+    void testErrorsListed();
+
+private:
+    QString writeFile(const QString &name, const QByteArray &contents);
+    int runAudit(const QStringList &arguments, QJsonObject *document = nullptr);
+
+    QTemporaryDir m_dir;
+};
+
+QString auditTest::writeFile(const QString &name, const QByteArray &contents)
+{
+    const QString path = m_dir.path() + QLatin1Char('/') + name;
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        return QString();
+    file.write(contents);
+    return path;
+}
+
+int auditTest::runAudit(const QStringList &arguments, QJsonObject *document)
+{
+    QProcess process;
+    process.setProcessChannelMode(QProcess::ForwardedErrorChannel);
+    process.start(QLatin1String(AUDIT_EXECUTABLE), arguments);
+    if (!process.waitForFinished() || process.exitStatus() != QProcess::NormalExit)
+        return -1;
+    if (document)
+        *document = QJsonDocument::fromJson(process.readAllStandardOutput()).object();
+    return process.exitCode();
+}
+
+void auditTest::initTestCase()
+{
+    QVERIFY(m_dir.isValid());
+    QVERIFY(!writeFile(QLatin1String("pkg_depends"),
+                       "tr:::kde-l10n-\n"
+                       "tr::firefox:firefox-locale-\n").isEmpty());
+    QVERIFY(!writeFile(QLatin1String("packages"),
+                       "kde-l10n-de installed\n"
+                       "kde-l10n-fr\n"
+                       "firefox installed\n"
+                       "firefox-locale-de installed\n"
+                       "firefox-locale-fr\n").isEmpty());
+    QVERIFY(QDir(m_dir.path()).mkpath(QLatin1String("emptyroot")));
+}
+
+void auditTest::testExitCode_data()
+{
+    QTest::addColumn<QStringList>("arguments");
+    QTest::addColumn<int>("exitCode");
+
+    const QString fixture = m_dir.path() + QLatin1String("/packages");
+    const QString pkgDepends = m_dir.path() + QLatin1String("/pkg_depends");
+    const QStringList fixtureArguments = QStringList()
+            << QLatin1String("--fixture") << fixture
+            << QLatin1String("--pkg-depends") << pkgDepends;
+
+    QTest::newRow("complete") << (QStringList(fixtureArguments) << QLatin1String("de")) << 0;
+    QTest::newRow("incomplete") << (QStringList(fixtureArguments) << QLatin1String("fr")) << 1;
+    QTest::newRow("unknown language")
+            << (QStringList(fixtureArguments) << QLatin1String("de") << QLatin1String("xx")) << 2;
+    QTest::newRow("missing pkg_depends")
+            << (QStringList() << QLatin1String("--fixture") << fixture
+                              << QLatin1String("--pkg-depends") << m_dir.path() + QLatin1String("/missing")
+                              << QLatin1String("de"))
+            << 2;
+    QTest::newRow("missing fixture")
+            << (QStringList() << QLatin1String("--fixture") << m_dir.path() + QLatin1String("/missing")) << 2;
+    QTest::newRow("root without dpkg status")
+            << (QStringList() << QLatin1String("--root") << m_dir.path() + QLatin1String("/emptyroot")) << 2;
+    QTest::newRow("root and fixture")
+            << (QStringList() << QLatin1String("--root") << m_dir.path()
+                              << QLatin1String("--fixture") << fixture)
+            << 2;
+}
+
+void auditTest::testExitCode()
+{
+    QFETCH(QStringList, arguments);
+    QFETCH(int, exitCode);
+
+    QCOMPARE(runAudit(arguments), exitCode);
+}
+
+void auditTest::testErrorsListed()
+{
+    QJsonObject document;
+    QCOMPARE(runAudit(QStringList() << QLatin1String("--compact")
+                                    << QLatin1String("--fixture") << m_dir.path() + QLatin1String("/packages")
+                                    << QLatin1String("--pkg-depends") << m_dir.path() + QLatin1String("/missing")
+                                    << QLatin1String("de") << QLatin1String("xx"),
+                      &document),
+             2);
+    QVERIFY(!document.value(QLatin1String("pkgDependsValid")).toBool());
+    QCOMPARE(document.value(QLatin1String("errors")).toArray().size(), 2);
+
+    // The known language is still audited.
+    const QJsonArray languages = document.value(QLatin1String("languages")).toArray();
+    QCOMPARE(languages.size(), 1);
+    QCOMPARE(languages.at(0).toObject().value(QLatin1String("language")).toString(), QLatin1String("de"));
+}
+
+QTEST_MAIN(auditTest)
+
+#include "audittest.moc"
@@ -0,0 +1,255 @@
+#include <QtTest>
+#include <QtCore>
+#include <QtWidgets>
+
+#include "../src/busyoverlay.h"
+
+using Kubuntu::BusyOverlay;
+
+class ProgressEmitter : public QObject
+{
+    Q_OBJECT
+public:
+    void emitProgress(int progress) { emit progressChanged(progress); }
+    void emitFinished() { emit finished(); }
+
+signals:
+    void progressChanged(int progress);
+    void finished();
+};
+
+// Counts events of one type delivered to an object.
+class EventCounter : public QObject
+{
+public:
+    EventCounter(QObject *object, QEvent::Type type)
+        : count(0)
+        , m_type(type)
+    {
+        object->installEventFilter(this);
+    }
+
+    bool eventFilter(QObject *, QEvent *event) Q_DECL_OVERRIDE
+    {
+        if (event->type() == m_type)
+            ++count;
+        return false;
+    }
+
+    int count;
+
+private:
+    const QEvent::Type m_type;
+};
+
+static void setBackground(QWidget *widget, const QColor &color)
+{
+    QPalette palette = widget->palette();
+    palette.setColor(widget->backgroundRole(), color);
+    widget->setPalette(palette);
+    widget->setAutoFillBackground(true);
+}
+
+// Whether the overlay shows color dimmed by its translucent black
+// background, sampled next to the corner where there are no children.
+static bool showsDimmed(QWidget *overlay, const QColor &color)
+{
+    const QRgb pixel = overlay->grab(QRect(1, 1, 1, 1)).toImage().pixel(0, 0);
+    const qreal factor = (255 - 165) / 255.0;
+    return qAbs(qRed(pixel) - qRound(color.red() * factor)) <= 2 &&
+           qAbs(qGreen(pixel) - qRound(color.green() * factor)) <= 2 &&
+           qAbs(qBlue(pixel) - qRound(color.blue() * factor)) <= 2;
+}
+
+class busyOverlayTest : public QObject
+{
+    Q_OBJECT
+private slots:
+    void init();
+    void cleanup();
+    void testProgress();
+    void testProgressRate();
+    void testProgressRateCoalesced();
+    void testSources();
+    void testSignalSources();
+    void testRepositionCoalesced();
+    void testSnapshot();
+
+private:
+    QProgressBar *progressBar() const;
+
+    QWidget *m_base;
+    QPointer<BusyOverlay> m_overlay;
+};
+
+void busyOverlayTest::init()
+{
+    m_base = new QWidget;
+    m_base->resize(200, 100);
+    m_overlay = new BusyOverlay(m_base);
+    QVERIFY(progressBar());
+}
+
+void busyOverlayTest::cleanup()
+{
+    delete m_base;
+    QVERIFY(!m_overlay);
+}
+
+QProgressBar *busyOverlayTest::progressBar() const
+{
+    return m_overlay->findChild<QProgressBar *>();
+}
+
+void busyOverlayTest::testProgress()
+{
+    QCOMPARE(m_overlay->maximumProgressRate(), 30);
+    m_overlay->setMaximumProgressRate(0);
+    m_overlay->setProgress(10);
+    QCOMPARE(progressBar()->value(), 10);
+    m_overlay->setProgress(20);
+    QCOMPARE(progressBar()->value(), 20);
+}
+
+void busyOverlayTest::testProgressRate()
+{
+    m_overlay->setMaximumProgressRate(5);
+    m_overlay->setProgress(10);
+    QCOMPARE(progressBar()->value(), 10);
+
+    // Within the interval, only the last value is shown once it passed.
+    m_overlay->setProgress(20);
+    m_overlay->setProgress(30);
+    QCOMPARE(progressBar()->value(), 10);
+    QTRY_COMPARE(progressBar()->value(), 30);
+
+    // The maximum is never held back.
+    m_overlay->setProgress(100);
+    QCOMPARE(progressBar()->value(), 100);
+}
+
+void busyOverlayTest::testProgressRateCoalesced()
+{
+    m_overlay->setMaximumProgressRate(5);
+    QSignalSpy spy(progressBar(), SIGNAL(valueChanged(int)));
+    m_overlay->setProgress(10);
+    QCOMPARE(spy.count(), 1);
+
+    // Repeated values cost nothing, a burst ends up as one trailing update.
+    m_overlay->setProgress(10);
+    for (int i = 11; i <= 20; ++i)
+        m_overlay->setProgress(i);
+    QCOMPARE(spy.count(), 1);
+    QTRY_COMPARE(progressBar()->value(), 20);
+    QCOMPARE(spy.count(), 2);
+
+    // Changing the rate shows a held back value right away, and only once.
+    m_overlay->setProgress(25);
+    QCOMPARE(progressBar()->value(), 20);
+    m_overlay->setMaximumProgressRate(0);
+    QCOMPARE(progressBar()->value(), 25);
+    QCOMPARE(spy.count(), 3);
+    QTest::qWait(300);
+    QCOMPARE(spy.count(), 3);
+}
+
+void busyOverlayTest::testSources()
+{
+    m_overlay->setMaximumProgressRate(0);
+    m_overlay->addProgressSource(QLatin1String("a"));
+    m_overlay->addProgressSource(QLatin1String("b"), 3);
+
+    m_overlay->setSourceProgress(QLatin1String("a"), 100);
+    QCOMPARE(progressBar()->value(), 25);
+    m_overlay->setSourceProgress(QLatin1String("b"), 50);
+    QCOMPARE(progressBar()->value(), 63);
+
+    m_overlay->finishProgressSource(QLatin1String("b"));
+    QCOMPARE(progressBar()->value(), 100);
+    QVERIFY(m_overlay);
+
+    m_overlay->finishProgressSource(QLatin1String("a"));
+    QTRY_VERIFY(!m_overlay);
+}
+
+void busyOverlayTest::testSignalSources()
+{
+    m_overlay->setMaximumProgressRate(0);
+    ProgressEmitter first;
+    ProgressEmitter *second = new ProgressEmitter;
+    m_overlay->addProgressSource(QLatin1String("first"), &first,
+                                 SIGNAL(progressChanged(int)), SIGNAL(finished()));
+    m_overlay->addProgressSource(QLatin1String("second"), second,
+                                 SIGNAL(progressChanged(int)), SIGNAL(finished()));
+
+    first.emitProgress(50);
+    QCOMPARE(progressBar()->value(), 25);
+    first.emitFinished();
+    QCOMPARE(progressBar()->value(), 50);
+
+    // Destruction of the sender finishes its source.
+    delete second;
+    QTRY_VERIFY(!m_overlay);
+}
+
+void busyOverlayTest::testRepositionCoalesced()
+{
+    QWidget window;
+    window.resize(300, 200);
+    QWidget *base = new QWidget(&window);
+    base->setGeometry(0, 0, 200, 100);
+    BusyOverlay *overlay = new BusyOverlay(base);
+    window.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&window));
+    QTRY_COMPARE(overlay->size(), QSize(200, 100));
+
+    // A burst of geometry changes is applied in one go once control
+    // returns to the event loop.
+    EventCounter resizes(overlay, QEvent::Resize);
+    for (int i = 1; i <= 10; ++i)
+        base->setGeometry(i, i, 200 + i, 100 + i);
+    QCOMPARE(overlay->size(), QSize(200, 100));
+    QTRY_COMPARE(overlay->size(), QSize(210, 110));
+    QTest::qWait(50);
+    QCOMPARE(resizes.count, 1);
+}
+
+void busyOverlayTest::testSnapshot()
+{
+    QWidget window;
+    window.resize(300, 200);
+    QWidget *base = new QWidget(&window);
+    base->setGeometry(0, 0, 200, 100);
+    setBackground(base, Qt::red);
+    BusyOverlay *overlay = new BusyOverlay(base);
+    window.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&window));
+    QTRY_COMPARE(overlay->size(), QSize(200, 100));
+
+    QVERIFY(!overlay->isSnapshotEnabled());
+    overlay->setSnapshotEnabled(true);
+    QVERIFY(overlay->isSnapshotEnabled());
+    QVERIFY(!overlay->autoFillBackground());
+    QVERIFY(overlay->testAttribute(Qt::WA_OpaquePaintEvent));
+    QVERIFY(showsDimmed(overlay, Qt::red));
+
+    // Neither content changes of the base nor repaints of the overlay
+    // cause a new grab...
+    setBackground(base, Qt::blue);
+    overlay->setMaximumProgressRate(0);
+    overlay->setProgress(50);
+    QTest::qWait(50);
+    QVERIFY(showsDimmed(overlay, Qt::red));
+
+    // ...resizes do.
+    base->resize(210, 110);
+    QTRY_VERIFY(showsDimmed(overlay, Qt::blue));
+
+    overlay->setSnapshotEnabled(false);
+    QVERIFY(overlay->autoFillBackground());
+    QVERIFY(!overlay->testAttribute(Qt::WA_OpaquePaintEvent));
+}
+
+QTEST_MAIN(busyOverlayTest)
+
+#include "busyoverlaytest.moc"
@@ -0,0 +1,152 @@
+#include <QtTest>
+#include <QtCore>
+
+#include "../src/l10n_dpkgstatus_p.h"
+
+class dpkgStatusTest : public QObject
+{
+    Q_OBJECT
+private slots:
+    void testParse();
+    void testMissingFile();
+    void testEmptyFile();
+    void testChangedPackages();
+
+private:
+    static Kubuntu::DpkgStatus::Ptr parse(QTemporaryFile *file, const QByteArray &contents);
+};
+
+void dpkgStatusTest::testParse()
+{
+    QTemporaryFile temp;
+    QVERIFY2(temp.open(), "opening temporary file failed");
+    temp.write("Package: kde-l10n-de\n"
+               "Status: install ok installed\n"
+               "Priority: optional\n"
+               "Version: 4:14.12.1-0ubuntu1\n"
+               "Description: German (de) localization files for KDE\n"
+               " This package contains German translations.\n"
+               "\n"
+               "Package: kde-l10n-fr\n"
+               "Status: deinstall ok config-files\n"
+               "Version: 4:14.12.1-0ubuntu1\n"
+               "\n"
+               "Package: firefox\n"
+               "Status: install reinstreq half-installed\n"
+               "Version: 35.0+build3-0ubuntu1\n"
+               "\n"
+               "Package: libc6\n"
+               "Status: hold ok installed\n"
+               "Architecture: amd64\n"
+               "Version: 2.19-10ubuntu2\n"
+               "\n"
+               "Package: libc6\n"
+               "Status: install ok installed\n"
+               "Architecture: i386\n"
+               "Version: 2.19-10ubuntu2\n");
+    temp.close();
+
+    Kubuntu::DpkgStatus::Ptr status = Kubuntu::DpkgStatus::fromFile(temp.fileName());
+    QVERIFY(status->isValid());
+    QCOMPARE(status->count(), 2);
+
+    QVERIFY(status->isInstalled(QLatin1String("kde-l10n-de")));
+    QCOMPARE(status->installedVersion(QLatin1String("kde-l10n-de")), QString("4:14.12.1-0ubuntu1"));
+    QVERIFY(status->isInstalled(QLatin1String("libc6")));
+    QCOMPARE(status->installedVersion(QLatin1String("libc6")), QString("2.19-10ubuntu2"));
+
+    QVERIFY(!status->isInstalled(QLatin1String("kde-l10n-fr")));
+    QVERIFY(!status->isInstalled(QLatin1String("firefox")));
+    QVERIFY(!status->isInstalled(QLatin1String("kde-l10n")));
+    QVERIFY(!status->isInstalled(QString()));
+    QVERIFY(status->installedVersion(QLatin1String("firefox")).isEmpty());
+}
+
+void dpkgStatusTest::testMissingFile()
+{
+    Kubuntu::DpkgStatus::Ptr status = Kubuntu::DpkgStatus::fromFile(QLatin1String("/dev/null/status"));
+    QVERIFY(!status->isValid());
+    QVERIFY(!status->isInstalled(QLatin1String("libc6")));
+}
+
+void dpkgStatusTest::testEmptyFile()
+{
+    QTemporaryFile temp;
+    QVERIFY2(temp.open(), "opening temporary file failed");
+    temp.close();
+
+    Kubuntu::DpkgStatus::Ptr status = Kubuntu::DpkgStatus::fromFile(temp.fileName());
+    QVERIFY(status->isValid());
+    QCOMPARE(status->count(), 0);
+    QVERIFY(!status->isInstalled(QLatin1String("libc6")));
+}
+
+Kubuntu::DpkgStatus::Ptr dpkgStatusTest::parse(QTemporaryFile *file, const QByteArray &contents)
+{
+    if (!file->open())
+        return Kubuntu::DpkgStatus::Ptr();
+    file->write(contents);
+    file->close();
+    return Kubuntu::DpkgStatus::fromFile(file->fileName());
+}
+
+void dpkgStatusTest::testChangedPackages()
+{
+    QTemporaryFile before;
+    Kubuntu::DpkgStatus::Ptr oldStatus = parse(&before,
+        "Package: unchanged\n"
+        "Status: install ok installed\n"
+        "Version: 1.0\n"
+        "\n"
+        "Package: upgraded\n"
+        "Status: install ok installed\n"
+        "Version: 1.0\n"
+        "\n"
+        "Package: removed\n"
+        "Status: install ok installed\n"
+        "Version: 1.0\n"
+        "\n"
+        "Package: configured\n"
+        "Status: deinstall ok config-files\n"
+        "Version: 1.0\n");
+    QVERIFY(oldStatus);
+
+    QTemporaryFile after;
+    Kubuntu::DpkgStatus::Ptr newStatus = parse(&after,
+        "Package: configured\n"
+        "Status: install ok installed\n"
+        "Version: 1.0\n"
+        "\n"
+        "Package: unchanged\n"
+        "Status: install ok installed\n"
+        "Version: 1.0\n"
+        "\n"
+        "Package: upgraded\n"
+        "Status: install ok installed\n"
+        "Version: 1.0.1\n"
+        "\n"
+        "Package: removed\n"
+        "Status: deinstall ok config-files\n"
+        "Version: 1.0\n"
+        "\n"
+        "Package: added\n"
+        "Status: install ok installed\n"
+        "Version: 2.0\n");
+    QVERIFY(newStatus);
+
+    const QSet<QString> changed = QSet<QString>() << "configured" << "upgraded" << "removed" << "added";
+    QCOMPARE(newStatus->changedPackages(*oldStatus), changed);
+    QCOMPARE(oldStatus->changedPackages(*newStatus), changed);
+    QVERIFY(newStatus->changedPackages(*newStatus).isEmpty());
+
+    // Everything is new compared to nothing.
+    QTemporaryFile empty;
+    Kubuntu::DpkgStatus::Ptr emptyStatus = parse(&empty, QByteArray());
+    QVERIFY(emptyStatus);
+    QCOMPARE(newStatus->changedPackages(*emptyStatus),
+             QSet<QString>() << "configured" << "unchanged" << "upgraded" << "added");
+}
+
+QTEST_MAIN(dpkgStatusTest)
+
+#include "dpkgstatustest.moc"
@@ -0,0 +1,233 @@
+#include <QtTest>
+#include <QtCore>
+
+#include <utime.h>
+
+#include "../src/l10n_dpkgstatus_p.h"
+#include "../src/l10n_language.h"
+#include "../src/l10n_languagecollection.h"
+#include "../src/l10n_memorypackageprovider_p.h"
+#include "../src/l10n_pkgdepends_p.h"
+
+using Kubuntu::Language;
+using Kubuntu::LanguageCollection;
+
+typedef QSet<Language *> LanguageSet;
+
+// A backend whose cache cannot be opened.
+class BrokenPackageProvider : public Kubuntu::MemoryPackageProvider
+{
+public:
+    virtual bool init() Q_DECL_OVERRIDE { return false; }
+};
+
+class languageCollectionTest : public QObject
+{
+    Q_OBJECT
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void init();
+    void testInvalid();
+    void testCheckSupport();
+    void testConcurrentCheckSupport();
+    void testSupportStatusWatched();
+
+private:
+    static QStringList codes(const LanguageSet &languages);
+    void writeStatus(const QStringList &installedPackages);
+
+    QTemporaryDir m_dir;
+    QString m_statusPath;
+    time_t m_statusTime;
+    Kubuntu::MemoryPackageProvider m_provider;
+};
+
+void languageCollectionTest::initTestCase()
+{
+    QVERIFY(m_dir.isValid());
+    const QString pkgDependsPath = m_dir.path() + QLatin1String("/pkg_depends");
+    QFile pkgDepends(pkgDependsPath);
+    QVERIFY(pkgDepends.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    pkgDepends.write("tr:::kde-l10n-\n"
+                     "tr::firefox:firefox-locale-\n");
+    pkgDepends.close();
+    Kubuntu::PkgDepends::setPath(pkgDependsPath);
+    Kubuntu::PackageProvider::setDefaultProvider(&m_provider);
+
+    m_statusPath = m_dir.path() + QLatin1String("/status");
+    m_statusTime = QDateTime::currentDateTime().toTime_t() - 1000;
+}
+
+void languageCollectionTest::cleanupTestCase()
+{
+    Kubuntu::PackageProvider::setDefaultProvider(nullptr);
+    Kubuntu::PkgDepends::setPath(QString());
+    Kubuntu::DpkgStatus::setPath(QString());
+}
+
+void languageCollectionTest::init()
+{
+    // Installs of a previous test must not leak.
+    m_provider.clear();
+    m_provider.addPackage(QLatin1String("kde-l10n-de"), true);
+    m_provider.addPackage(QLatin1String("kde-l10n-fr"));
+    m_provider.addPackage(QLatin1String("kde-l10n-ptbr"));
+    m_provider.addPackage(QLatin1String("firefox"), true);
+    m_provider.addPackage(QLatin1String("firefox-locale-de"));
+    m_provider.addPackage(QLatin1String("firefox-locale-fr"));
+    m_provider.addPackage(QLatin1String("firefox-locale-pt"), true);
+}
+
+QStringList languageCollectionTest::codes(const LanguageSet &languages)
+{
+    QStringList codes;
+    foreach (Language *language, languages)
+        codes << language->kdeLanguageCode();
+    codes.sort();
+    return codes;
+}
+
+// Replaces the status file like dpkg does. The modification time is set
+// explicitly as two writes may otherwise end up with the same one.
+void languageCollectionTest::writeStatus(const QStringList &installedPackages)
+{
+    QSaveFile file(m_statusPath);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    foreach (const QString &package, installedPackages) {
+        file.write("Package: " + package.toLatin1() + "\n"
+                   "Status: install ok installed\n"
+                   "Version: 1.0\n"
+                   "\n");
+    }
+    QVERIFY(file.commit());
+
+    struct utimbuf times;
+    times.actime = times.modtime = ++m_statusTime;
+    QCOMPARE(utime(QFile::encodeName(m_statusPath).constData(), &times), 0);
+}
+
+void languageCollectionTest::testInvalid()
+{
+    QVERIFY(LanguageCollection().isValid());
+
+    BrokenPackageProvider provider;
+    provider.addPackage(QLatin1String("kde-l10n-de"), true);
+    Kubuntu::PackageProvider::setDefaultProvider(&provider);
+    LanguageCollection collection;
+    Kubuntu::PackageProvider::setDefaultProvider(&m_provider);
+    QVERIFY(!collection.isValid());
+    QVERIFY(collection.languages().isEmpty());
+    QVERIFY(collection.languageInfos().isEmpty());
+    QVERIFY(!collection.languageInfo(QLatin1String("de")).isValid());
+}
+
+void languageCollectionTest::testCheckSupport()
+{
+    LanguageCollection collection;
+    const LanguageSet languages = collection.languages();
+    QCOMPARE(codes(languages), QStringList() << "de" << "en_US" << "fr" << "pt_BR");
+
+    QSignalSpy languageSpy(&collection, SIGNAL(languageSupportChecked(Kubuntu::Language*,bool)));
+    QSignalSpy spy(&collection, SIGNAL(supportChecked(QSet<Kubuntu::Language*>)));
+    collection.checkSupport(languages);
+    QVERIFY(spy.wait());
+    QCOMPARE(spy.count(), 1);
+    QCOMPARE(codes(spy.at(0).at(0).value<LanguageSet>()), QStringList() << "de" << "fr" << "pt_BR");
+
+    // Every Language is reported exactly once with its own result.
+    QCOMPARE(languageSpy.count(), 4);
+    QHash<QString, bool> results;
+    foreach (const QList<QVariant> &arguments, languageSpy) {
+        Language *language = arguments.at(0).value<Language *>();
+        QVERIFY(languages.contains(language));
+        QVERIFY(!results.contains(language->kdeLanguageCode()));
+        results.insert(language->kdeLanguageCode(), arguments.at(1).toBool());
+    }
+    QCOMPARE(results.value(QLatin1String("en_US")), true);
+    QCOMPARE(results.value(QLatin1String("de")), false);
+    QCOMPARE(results.value(QLatin1String("fr")), false);
+    QCOMPARE(results.value(QLatin1String("pt_BR")), false);
+
+    QStringList missing = collection.language(QLatin1String("fr"))->missingPackages();
+    missing.sort();
+    QCOMPARE(missing, QStringList() << "firefox-locale-fr" << "kde-l10n-fr");
+
+    // Languages of other collections are left alone.
+    Language foreign(QLatin1String("de"));
+    collection.checkSupport(LanguageSet() << &foreign);
+    QVERIFY(spy.wait());
+    QVERIFY(spy.at(1).at(0).value<LanguageSet>().isEmpty());
+    QCOMPARE(languageSpy.count(), 4);
+}
+
+void languageCollectionTest::testConcurrentCheckSupport()
+{
+    LanguageCollection collection;
+    const LanguageSet languages = collection.languages();
+    Language *de = collection.language(QLatin1String("de"));
+
+    QSignalSpy languageSpy(&collection, SIGNAL(languageSupportChecked(Kubuntu::Language*,bool)));
+    QSignalSpy spy(&collection, SIGNAL(supportChecked(QSet<Kubuntu::Language*>)));
+    collection.checkSupport(LanguageSet() << de);
+    // Merged into the running check, de is not checked twice.
+    collection.checkSupport(languages);
+    QVERIFY(spy.wait());
+    QCOMPARE(codes(spy.at(0).at(0).value<LanguageSet>()), QStringList() << "de" << "fr" << "pt_BR");
+    QCOMPARE(languageSpy.count(), 4);
+
+    QTest::qWait(100);
+    QCOMPARE(spy.count(), 1);
+}
+
+void languageCollectionTest::testSupportStatusWatched()
+{
+    writeStatus(QStringList() << "kde-l10n-de" << "firefox" << "firefox-locale-pt");
+    Kubuntu::DpkgStatus::setPath(m_statusPath);
+
+    LanguageCollection collection;
+    Language *de = collection.language(QLatin1String("de"));
+    Language *fr = collection.language(QLatin1String("fr"));
+    QSignalSpy checkedSpy(&collection, SIGNAL(supportChecked(QSet<Kubuntu::Language*>)));
+    collection.checkSupport(LanguageSet() << de << fr);
+    QVERIFY(checkedSpy.wait());
+    QCOMPARE(de->missingPackages(), QStringList() << "firefox-locale-de");
+
+    QVERIFY(!collection.isSupportStatusWatched());
+    collection.setSupportStatusWatched(true);
+    QVERIFY(collection.isSupportStatusWatched());
+    QSignalSpy deSpy(de, SIGNAL(supportStatusChanged(bool)));
+    QSignalSpy frSpy(fr, SIGNAL(supportStatusChanged(bool)));
+
+    // Only de depends on the installed package.
+    m_provider.addPackage(QLatin1String("firefox-locale-de"), true);
+    writeStatus(QStringList() << "kde-l10n-de" << "firefox" << "firefox-locale-pt" << "firefox-locale-de");
+    QVERIFY(deSpy.wait());
+    QCOMPARE(deSpy.count(), 1);
+    QCOMPARE(deSpy.at(0).at(0).toBool(), true);
+    QVERIFY(de->missingPackages().isEmpty());
+    QCOMPARE(frSpy.count(), 0);
+
+    // Both depend on the removed trigger, but only the missing packages of
+    // fr change.
+    m_provider.addPackage(QLatin1String("firefox"), false);
+    writeStatus(QStringList() << "kde-l10n-de" << "firefox-locale-pt" << "firefox-locale-de");
+    QVERIFY(frSpy.wait());
+    QCOMPARE(frSpy.count(), 1);
+    QCOMPARE(frSpy.at(0).at(0).toBool(), false);
+    QCOMPARE(fr->missingPackages(), QStringList() << "kde-l10n-fr");
+    QCOMPARE(deSpy.count(), 1);
+
+    // Nothing is re-evaluated once watching stopped.
+    collection.setSupportStatusWatched(false);
+    m_provider.addPackage(QLatin1String("kde-l10n-fr"), true);
+    writeStatus(QStringList() << "kde-l10n-de" << "kde-l10n-fr" << "firefox-locale-pt" << "firefox-locale-de");
+    QVERIFY(!frSpy.wait(1000));
+    QCOMPARE(fr->missingPackages(), QStringList() << "kde-l10n-fr");
+
+    Kubuntu::DpkgStatus::setPath(QString());
+}
+
+QTEST_MAIN(languageCollectionTest)
+
+#include "languagecollectiontest.moc"
@@ -0,0 +1,174 @@
+#include <QtTest>
+#include <QtCore>
+
+#include "../src/l10n_language.h"
+#include "../src/l10n_languagecollection.h"
+#include "../src/l10n_languageinfo.h"
+#include "../src/l10n_memorypackageprovider_p.h"
+#include "../src/l10n_statistics.h"
+
+using Kubuntu::LanguageCollection;
+using Kubuntu::LanguageInfo;
+using Kubuntu::Statistics;
+
+// Counts the queries the collection makes.
+class CountingPackageProvider : public Kubuntu::MemoryPackageProvider
+{
+public:
+    CountingPackageProvider() : queries(0) {}
+
+    virtual QStringList packagesWithPrefix(const QString &prefix) Q_DECL_OVERRIDE
+    {
+        ++queries;
+        return Kubuntu::MemoryPackageProvider::packagesWithPrefix(prefix);
+    }
+
+    int queries;
+};
+
+class languageInfoTest : public QObject
+{
+    Q_OBJECT
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void testInvalid();
+    void testAll();
+    void testPrefix();
+    void testInstalled();
+    void testLookup();
+    void testNoLanguages();
+    void testCached();
+
+private:
+    static QStringList codes(const QList<LanguageInfo> &infos);
+
+    Kubuntu::MemoryPackageProvider m_provider;
+};
+
+void languageInfoTest::initTestCase()
+{
+    m_provider.addPackage(QLatin1String("kde-l10n-de"), true);
+    m_provider.addPackage(QLatin1String("kde-l10n-engb"));
+    m_provider.addPackage(QLatin1String("kde-l10n-ca-valencia"));
+    m_provider.addPackage(QLatin1String("kde-l10n-ca"), true);
+    m_provider.addPackage(QLatin1String("kde-l10n-ptbr"), true);
+    m_provider.addPackage(QLatin1String("language-pack-de"), true);
+    Kubuntu::PackageProvider::setDefaultProvider(&m_provider);
+}
+
+void languageInfoTest::cleanupTestCase()
+{
+    Kubuntu::PackageProvider::setDefaultProvider(nullptr);
+}
+
+QStringList languageInfoTest::codes(const QList<LanguageInfo> &infos)
+{
+    QStringList codes;
+    foreach (const LanguageInfo &info, infos)
+        codes << info.kdeLanguageCode();
+    codes.sort();
+    return codes;
+}
+
+void languageInfoTest::testInvalid()
+{
+    LanguageInfo info;
+    QVERIFY(!info.isValid());
+    QVERIFY(info.kdeLanguageCode().isEmpty());
+    QVERIFY(!info.isInstalled());
+}
+
+void languageInfoTest::testAll()
+{
+    LanguageCollection collection;
+    Statistics::reset();
+    const QList<LanguageInfo> infos = collection.languageInfos();
+    QCOMPARE(codes(infos), QStringList() << "ca" << "ca@valencia" << "de" << "en_GB"
+                                         << "en_US" << "pt_BR");
+    // Listing does not materialize Languages.
+    QCOMPARE(Statistics::snapshot().count(Statistics::LanguagesCreated), quint64(0));
+    QVERIFY(collection.findChildren<Kubuntu::Language *>().isEmpty());
+}
+
+void languageInfoTest::testPrefix()
+{
+    LanguageCollection collection;
+    QCOMPARE(codes(collection.languageInfos(QLatin1String("ca"))),
+             QStringList() << "ca" << "ca@valencia");
+    QCOMPARE(codes(collection.languageInfos(QLatin1String("en"))),
+             QStringList() << "en_GB" << "en_US");
+    QVERIFY(collection.languageInfos(QLatin1String("xx")).isEmpty());
+}
+
+void languageInfoTest::testInstalled()
+{
+    LanguageCollection collection;
+    QCOMPARE(codes(collection.languageInfos(QString(), LanguageCollection::InstalledLanguages)),
+             QStringList() << "ca" << "de" << "en_US" << "pt_BR");
+    QCOMPARE(codes(collection.languageInfos(QLatin1String("ca"), LanguageCollection::InstalledLanguages)),
+             QStringList() << "ca");
+}
+
+void languageInfoTest::testLookup()
+{
+    LanguageCollection collection;
+
+    const LanguageInfo ptBr = collection.languageInfo(QLatin1String("pt_BR"));
+    QVERIFY(ptBr.isValid());
+    QCOMPARE(ptBr.kdeLanguageCode(), QString("pt_BR"));
+    QCOMPARE(ptBr.kdePackageCode(), QString("ptbr"));
+    QCOMPARE(ptBr.ubuntuPackageCode(), QString("pt"));
+    QVERIFY(ptBr.isInstalled());
+
+    const LanguageInfo valencia = collection.languageInfo(QLatin1String("ca@valencia"));
+    QVERIFY(valencia.isValid());
+    QCOMPARE(valencia.kdePackageCode(), QString("ca-valencia"));
+    QVERIFY(!valencia.isInstalled());
+
+    QVERIFY(collection.languageInfo(QLatin1String("en_US")).isValid());
+    QVERIFY(!collection.languageInfo(QLatin1String("fr")).isValid());
+
+    // Management still goes through the collection's Language.
+    Kubuntu::Language *language = collection.language(ptBr.kdeLanguageCode());
+    QCOMPARE(language->kdePackageCode(), ptBr.kdePackageCode());
+}
+
+void languageInfoTest::testNoLanguages()
+{
+    Kubuntu::MemoryPackageProvider provider;
+    Kubuntu::PackageProvider::setDefaultProvider(&provider);
+    {
+        LanguageCollection collection;
+        // en_US is always available.
+        QCOMPARE(codes(collection.languageInfos()), QStringList() << "en_US");
+    }
+    Kubuntu::PackageProvider::setDefaultProvider(&m_provider);
+}
+
+void languageInfoTest::testCached()
+{
+    CountingPackageProvider provider;
+    provider.addPackage(QLatin1String("kde-l10n-de"));
+    Kubuntu::PackageProvider::setDefaultProvider(&provider);
+    {
+        LanguageCollection collection;
+        QCOMPARE(codes(collection.languageInfos()), QStringList() << "de" << "en_US");
+        QCOMPARE(provider.queries, 1);
+
+        // Answered from the cache until packages change.
+        QCOMPARE(codes(collection.languageInfos(QLatin1String("de"))), QStringList() << "de");
+        QCOMPARE(collection.languages().size(), 2);
+        QCOMPARE(provider.queries, 1);
+
+        provider.addPackage(QLatin1String("kde-l10n-fr"), true);
+        QCOMPARE(codes(collection.languageInfos(QString(), LanguageCollection::InstalledLanguages)),
+                 QStringList() << "en_US" << "fr");
+        QCOMPARE(provider.queries, 2);
+    }
+    Kubuntu::PackageProvider::setDefaultProvider(&m_provider);
+}
+
+QTEST_MAIN(languageInfoTest)
+
+#include "languageinfotest.moc"
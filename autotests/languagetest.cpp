@@ -2,6 +2,8 @@
 #include <QtCore>
 
 #include "../src/l10n_language.h"
+#include "../src/l10n_memorypackageprovider_p.h"
+#include "../src/l10n_pkgdepends_p.h"
 
 class languageTest : public QObject
 {
@@ -9,6 +11,14 @@ class languageTest : public QObject
 private slots:
     void testVariantStripping();
     void testCountryStripping();
+    void testSupport();
+    void testCompleteSupport();
+    void testSupportPerProvider();
+
+private:
+    void setUpFixture(Kubuntu::MemoryPackageProvider *provider);
+
+    QTemporaryDir m_dir;
 };
 
 void languageTest::testVariantStripping()
@@ -25,7 +35,101 @@ void languageTest::testCountryStripping()
     QCOMPARE(l.systemLanguageCode(), QString("en"));
 }
 
-#warning how to test the silly package support nonesense?
+void languageTest::setUpFixture(Kubuntu::MemoryPackageProvider *provider)
+{
+    QVERIFY(m_dir.isValid());
+    const QString pkgDependsPath = m_dir.path() + QLatin1String("/pkg_depends");
+    QFile pkgDepends(pkgDependsPath);
+    QVERIFY(pkgDepends.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    pkgDepends.write("tr:::kde-l10n-\n"
+                     "tr:::language-pack-\n"
+                     "tr::firefox:firefox-locale-\n"
+                     "tr::libreoffice-common:libreoffice-l10n-\n"
+                     "tr:pt::hunspell-\n"
+                     "tr:de::hunspell-\n"
+                     "tr:pt::notavailable-\n");
+    pkgDepends.close();
+    Kubuntu::PkgDepends::setPath(pkgDependsPath);
+
+    const QString packagesPath = m_dir.path() + QLatin1String("/packages");
+    QFile packages(packagesPath);
+    QVERIFY(packages.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    packages.write("# name [installed]\n"
+                   "kde-l10n-ptbr\n"
+                   "language-pack-pt installed\n"
+                   "firefox installed\n"
+                   "firefox-locale-pt\n"
+                   "libreoffice-l10n-pt\n"
+                   "hunspell-pt\n");
+    packages.close();
+    QVERIFY(provider->load(packagesPath));
+    QCOMPARE(provider->count(), 6);
+}
+
+void languageTest::testSupport()
+{
+    Kubuntu::MemoryPackageProvider provider;
+    setUpFixture(&provider);
+    Kubuntu::PackageProvider::setDefaultProvider(&provider);
+
+    Kubuntu::Language l(QLatin1String("pt_BR"));
+    QVERIFY(!l.isSupportComplete());
+    QStringList missing = l.missingPackages();
+    missing.sort();
+    // libreoffice is not installed, notavailable-pt is not a package and the
+    // German rule does not apply.
+    QCOMPARE(missing, QStringList() << "firefox-locale-pt" << "hunspell-pt" << "kde-l10n-ptbr");
+
+    Kubuntu::PackageProvider::setDefaultProvider(nullptr);
+    Kubuntu::PkgDepends::setPath(QString());
+}
+
+void languageTest::testCompleteSupport()
+{
+    Kubuntu::MemoryPackageProvider provider;
+    setUpFixture(&provider);
+    Kubuntu::PackageProvider::setDefaultProvider(&provider);
+
+    Kubuntu::Language l(QLatin1String("pt_BR"));
+    QVERIFY(!l.isSupportComplete());
+
+    QSignalSpy completeSpy(&l, SIGNAL(supportComplete()));
+    QSignalSpy failedSpy(&l, SIGNAL(supportCompletionFailed()));
+    l.completeSupport();
+    QVERIFY(completeSpy.wait());
+    QCOMPARE(failedSpy.count(), 0);
+    QVERIFY(provider.isInstalled(QLatin1String("kde-l10n-ptbr")));
+    QVERIFY(l.isSupportComplete());
+    QVERIFY(l.missingPackages().isEmpty());
+
+    Kubuntu::PackageProvider::setDefaultProvider(nullptr);
+    Kubuntu::PkgDepends::setPath(QString());
+}
+
+void languageTest::testSupportPerProvider()
+{
+    Kubuntu::MemoryPackageProvider provider;
+    setUpFixture(&provider);
+    Kubuntu::MemoryPackageProvider completeProvider;
+    completeProvider.addPackage(QLatin1String("language-pack-pt"), true);
+
+    // Same code, different package states. Neither may answer from the
+    // other's evaluation.
+    Kubuntu::PackageProvider::setDefaultProvider(&provider);
+    Kubuntu::Language incomplete(QLatin1String("pt_BR"));
+    QVERIFY(!incomplete.isSupportComplete());
+
+    Kubuntu::PackageProvider::setDefaultProvider(&completeProvider);
+    Kubuntu::Language complete(QLatin1String("pt_BR"));
+    QVERIFY(complete.isSupportComplete());
+    QVERIFY(complete.missingPackages().isEmpty());
+
+    QVERIFY(!incomplete.missingPackages().isEmpty());
+    QVERIFY(!incomplete.isSupportComplete());
+
+    Kubuntu::PackageProvider::setDefaultProvider(nullptr);
+    Kubuntu::PkgDepends::setPath(QString());
+}
 
 QTEST_MAIN(languageTest)
 
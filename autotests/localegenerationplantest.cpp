@@ -0,0 +1,125 @@
+#include <QtTest>
+#include <QtCore>
+
+#include "../src/l10n_locale.h"
+#include "../src/l10n_localegenerationplan.h"
+#include "../src/l10n_systemlocales_p.h"
+
+using Kubuntu::SystemLocales;
+
+class localeGenerationPlanTest : public QObject
+{
+    Q_OBJECT
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void testNormalized();
+    void testPlan();
+    void testWriteLocaleGen();
+    void testModifier();
+
+private:
+    QTemporaryFile m_supported;
+};
+
+void localeGenerationPlanTest::initTestCase()
+{
+    QVERIFY2(m_supported.open(), "opening temporary file failed");
+    m_supported.write("de_AT.UTF-8 UTF-8\n"
+                      "de_AT ISO-8859-1\n"
+                      "de_DE.UTF-8 UTF-8\n"
+                      "fr_FR.UTF-8 UTF-8\n"
+                      "ca_ES.UTF-8 UTF-8\n"
+                      "ca_ES.UTF-8@valencia UTF-8\n");
+    m_supported.close();
+    SystemLocales::setSupportedPath(m_supported.fileName());
+    SystemLocales::setAvailable(QStringList() << "C" << "C.UTF-8" << "POSIX" << "ca_ES.utf8" << "de_DE.utf8");
+}
+
+void localeGenerationPlanTest::cleanupTestCase()
+{
+    SystemLocales::setSupportedPath(QString());
+    SystemLocales::invalidate();
+}
+
+void localeGenerationPlanTest::testNormalized()
+{
+    QCOMPARE(SystemLocales::normalized(QLatin1String("de_AT.UTF-8")), QString("de_at"));
+    QCOMPARE(SystemLocales::normalized(QLatin1String("de_AT.utf8")), QString("de_at"));
+    QCOMPARE(SystemLocales::normalized(QLatin1String("ca_ES.UTF-8@valencia")), QString("ca_es@valencia"));
+    QCOMPARE(SystemLocales::normalized(QLatin1String("ca_ES.utf8@valencia")), QString("ca_es@valencia"));
+    QCOMPARE(SystemLocales::normalized(QLatin1String("ca_ES@valencia")), QString("ca_es@valencia"));
+    QVERIFY(SystemLocales::isAvailable(QLatin1String("de_DE.UTF-8")));
+    QVERIFY(!SystemLocales::isAvailable(QLatin1String("de_AT.UTF-8")));
+}
+
+void localeGenerationPlanTest::testPlan()
+{
+    Kubuntu::LocaleGenerationPlan plan;
+    QVERIFY(plan.isEmpty());
+
+    plan.addLocale(Kubuntu::Locale(QList<QString>() << "de", QLatin1String("AT")));
+    plan.addLocale(Kubuntu::Locale(QList<QString>() << "de", QLatin1String("DE"))); // Available.
+    plan.addLocale(Kubuntu::Locale(QList<QString>() << "fr" << "de", QLatin1String("FR")));
+    plan.addLocale(Kubuntu::Locale(QList<QString>() << "de", QLatin1String("AT"))); // Duplicate.
+    plan.addLocale(Kubuntu::Locale(QList<QString>() << "en_US", QLatin1String("AT"))); // Unsupported.
+
+    QVERIFY(!plan.isEmpty());
+    QCOMPARE(plan.missingLocales(), QStringList() << "de_AT.UTF-8" << "fr_FR.UTF-8");
+    QCOMPARE(plan.unsupportedLocales(), QStringList() << "en_AT.UTF-8");
+    QCOMPARE(plan.command(), QStringList() << "locale-gen" << "de_AT.UTF-8" << "fr_FR.UTF-8");
+}
+
+void localeGenerationPlanTest::testWriteLocaleGen()
+{
+    QTemporaryFile localeGen;
+    QVERIFY2(localeGen.open(), "opening temporary file failed");
+    localeGen.write("# This file lists locales that you wish to have built.\n"
+                    "# de_AT.UTF-8 UTF-8\n"
+                    "# de_AT ISO-8859-1\n"
+                    "en_US.UTF-8 UTF-8\n");
+    localeGen.close();
+
+    Kubuntu::LocaleGenerationPlan plan;
+    plan.addLocale(Kubuntu::Locale(QList<QString>() << "de", QLatin1String("AT")));
+    plan.addLocale(Kubuntu::Locale(QList<QString>() << "fr", QLatin1String("FR")));
+    QVERIFY(plan.writeLocaleGen(localeGen.fileName()));
+
+    QFile file(localeGen.fileName());
+    QVERIFY(file.open(QIODevice::ReadOnly | QIODevice::Text));
+    QCOMPARE(file.readAll(), QByteArray("# This file lists locales that you wish to have built.\n"
+                                        "de_AT.UTF-8 UTF-8\n"
+                                        "# de_AT ISO-8859-1\n"
+                                        "en_US.UTF-8 UTF-8\n"
+                                        "fr_FR.UTF-8 UTF-8\n"));
+}
+
+void localeGenerationPlanTest::testModifier()
+{
+    // Only ca_ES is generated, ca_ES@valencia is a locale of its own.
+    QVERIFY(SystemLocales::isAvailable(QLatin1String("ca_ES.UTF-8")));
+    QVERIFY(!SystemLocales::isAvailable(QLatin1String("ca_ES.UTF-8@valencia")));
+    QVERIFY(SystemLocales::isSupported(QLatin1String("ca_ES.UTF-8@valencia")));
+
+    Kubuntu::LocaleGenerationPlan plan;
+    plan.addLocale(Kubuntu::Locale(QList<QString>() << "ca", QLatin1String("ES")));
+    plan.addLocale(Kubuntu::Locale(QList<QString>() << "ca@valencia", QLatin1String("ES")));
+    QCOMPARE(plan.missingLocales(), QStringList() << "ca_ES.UTF-8@valencia");
+    QVERIFY(plan.unsupportedLocales().isEmpty());
+
+    QTemporaryFile localeGen;
+    QVERIFY2(localeGen.open(), "opening temporary file failed");
+    localeGen.write("# ca_ES.UTF-8 UTF-8\n"
+                    "# ca_ES.UTF-8@valencia UTF-8\n");
+    localeGen.close();
+    QVERIFY(plan.writeLocaleGen(localeGen.fileName()));
+
+    QFile file(localeGen.fileName());
+    QVERIFY(file.open(QIODevice::ReadOnly | QIODevice::Text));
+    QCOMPARE(file.readAll(), QByteArray("# ca_ES.UTF-8 UTF-8\n"
+                                        "ca_ES.UTF-8@valencia UTF-8\n"));
+}
+
+QTEST_MAIN(localeGenerationPlanTest)
+
+#include "localegenerationplantest.moc"
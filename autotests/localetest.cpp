@@ -3,6 +3,8 @@
 
 #include "../src/l10n_language.h"
 #include "../src/l10n_locale.h"
+#include "../src/l10n_memorypackageprovider_p.h"
+#include "../src/l10n_pkgdepends_p.h"
 
 class localeTest : public QObject
 {
@@ -13,8 +15,10 @@ private slots:
     void testKdeLocaleStringCtor();
     void testComplexList();
     void testEnUsComplexityException();
+    void testDuplicateCodes();
     void testWriteFile();
     void testWriteFileWithInvalidLocale();
+    void testSupport();
 };
 
 typedef QList<Kubuntu::Language *> LangPtrList;
@@ -88,6 +92,16 @@ void localeTest::testEnUsComplexityException()
     QCOMPARE(l.systemLanguagesString(), QLatin1String("en"));
 }
 
+void localeTest::testDuplicateCodes()
+{
+    // Duplicate codes share one Language, which must only get deleted once.
+    QList<QString> codes;
+    codes << QLatin1String("en_US") << QLatin1String("de") << QLatin1String("en_US");
+    Kubuntu::Locale l(codes, QLatin1String("US"));
+    QCOMPARE(l.systemLocaleString(), QLatin1String("en_US.UTF-8"));
+    QCOMPARE(l.systemLanguagesString(), QLatin1String("en:de:en"));
+}
+
 void localeTest::testWriteFile()
 {
     QTemporaryFile temp;
@@ -148,6 +162,47 @@ void localeTest::testWriteFileWithInvalidLocale()
     QVERIFY(temp.atEnd());
 }
 
+void localeTest::testSupport()
+{
+    QTemporaryFile pkgDepends;
+    QVERIFY2(pkgDepends.open(), "opening temporary file failed");
+    pkgDepends.write("tr:::kde-l10n-\n"
+                     "tr::firefox:firefox-locale-\n"
+                     "tr:de::language-pack-de\n");
+    pkgDepends.close();
+    Kubuntu::PkgDepends::setPath(pkgDepends.fileName());
+
+    Kubuntu::MemoryPackageProvider provider;
+    provider.addPackage(QLatin1String("firefox"), true);
+    provider.addPackage(QLatin1String("firefox-locale-de"));
+    provider.addPackage(QLatin1String("firefox-locale-fr"), true);
+    provider.addPackage(QLatin1String("kde-l10n-de"));
+    provider.addPackage(QLatin1String("kde-l10n-fr"));
+    Kubuntu::PackageProvider::setDefaultProvider(&provider);
+
+    {
+        // de twice to make sure it is only evaluated and listed once.
+        Kubuntu::Locale l(QList<QString>() << "de" << "fr" << "de", QLatin1String("DE"));
+        QVERIFY(!l.isSupportComplete());
+        QStringList missing = l.missingPackages();
+        missing.sort();
+        QCOMPARE(missing, QStringList() << "firefox-locale-de" << "kde-l10n-de" << "kde-l10n-fr");
+
+        Kubuntu::Language *language = l.completeSupport();
+        QVERIFY(language);
+        QCOMPARE(language->kdeLanguageCode(), QString("de"));
+        // Nothing new is started while the transaction is running.
+        QVERIFY(!l.completeSupport());
+        QSignalSpy spy(language, SIGNAL(supportComplete()));
+        QVERIFY(spy.wait());
+        QVERIFY(l.isSupportComplete());
+        QVERIFY(!l.completeSupport());
+    }
+
+    Kubuntu::PackageProvider::setDefaultProvider(nullptr);
+    Kubuntu::PkgDepends::setPath(QString());
+}
+
 QTEST_MAIN(localeTest)
 
 #include "localetest.moc"
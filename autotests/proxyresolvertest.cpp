@@ -0,0 +1,123 @@
+#include <QtTest>
+#include <QtCore>
+
+#include "../src/l10n_proxyresolver_p.h"
+
+using Kubuntu::ProxyResolver;
+
+class proxyResolverTest : public QObject
+{
+    Q_OBJECT
+private slots:
+    void init();
+    void cleanup();
+    void testManual_data();
+    void testManual();
+    void testNoProxy_data();
+    void testNoProxy();
+    void testEnvironment();
+    void testUnset();
+    void testConfigPath();
+
+private:
+    void writeConfig(const QByteArray &contents);
+
+    QTemporaryDir m_dir;
+    QString m_path;
+};
+
+void proxyResolverTest::init()
+{
+    QVERIFY(m_dir.isValid());
+    m_path = m_dir.path() + QLatin1String("/kioslaverc");
+    ProxyResolver::setConfigPath(m_path);
+    qunsetenv("http_proxy");
+    qunsetenv("HTTP_PROXY");
+    qunsetenv("KUBUNTU_TEST_PROXY");
+}
+
+void proxyResolverTest::cleanup()
+{
+    ProxyResolver::setConfigPath(QString());
+    QFile::remove(m_path);
+}
+
+void proxyResolverTest::writeConfig(const QByteArray &contents)
+{
+    QFile file(m_path);
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    file.write(contents);
+    file.close();
+    // Force a read regardless of the modification time resolution.
+    ProxyResolver::setConfigPath(m_path);
+}
+
+void proxyResolverTest::testManual_data()
+{
+    QTest::addColumn<QByteArray>("value");
+    QTest::addColumn<QString>("proxy");
+    QTest::newRow("port separated by space") << QByteArray("http://proxy.example 3128")
+                                            << QString::fromLatin1("http://proxy.example:3128");
+    QTest::newRow("port separated by colon") << QByteArray("http://proxy.example:3128")
+                                            << QString::fromLatin1("http://proxy.example:3128");
+    QTest::newRow("no scheme") << QByteArray("proxy.example 3128")
+                               << QString::fromLatin1("http://proxy.example:3128");
+    QTest::newRow("empty") << QByteArray() << QString();
+}
+
+void proxyResolverTest::testManual()
+{
+    QFETCH(QByteArray, value);
+    QFETCH(QString, proxy);
+    writeConfig("[Proxy Settings]\nProxyType=1\nhttpProxy=" + value + "\n");
+    QCOMPARE(ProxyResolver::httpProxy(), proxy);
+}
+
+void proxyResolverTest::testNoProxy_data()
+{
+    QTest::addColumn<int>("type");
+    QTest::newRow("none") << 0;
+    QTest::newRow("pac") << 2;
+    QTest::newRow("wpad") << 3;
+}
+
+void proxyResolverTest::testNoProxy()
+{
+    QFETCH(int, type);
+    qputenv("http_proxy", "http://env.example:8080");
+    writeConfig("[Proxy Settings]\nProxyType=" + QByteArray::number(type) +
+                "\nhttpProxy=http://proxy.example 3128\n");
+    QCOMPARE(ProxyResolver::httpProxy(), QString());
+}
+
+void proxyResolverTest::testEnvironment()
+{
+    writeConfig("[Proxy Settings]\nProxyType=4\nhttpProxy=KUBUNTU_TEST_PROXY,http_proxy\n");
+    QCOMPARE(ProxyResolver::httpProxy(), QString());
+
+    // The environment is read on every call.
+    qputenv("http_proxy", "http://env.example:8080");
+    QCOMPARE(ProxyResolver::httpProxy(), QString::fromLatin1("http://env.example:8080"));
+    qputenv("KUBUNTU_TEST_PROXY", "http://first.example:8080");
+    QCOMPARE(ProxyResolver::httpProxy(), QString::fromLatin1("http://first.example:8080"));
+}
+
+void proxyResolverTest::testUnset()
+{
+    // Without any settings the usual variables apply.
+    QCOMPARE(ProxyResolver::httpProxy(), QString());
+    qputenv("HTTP_PROXY", "http://env.example:8080");
+    QCOMPARE(ProxyResolver::httpProxy(), QString::fromLatin1("http://env.example:8080"));
+}
+
+void proxyResolverTest::testConfigPath()
+{
+    QCOMPARE(ProxyResolver::configPath(), m_path);
+    ProxyResolver::setConfigPath(QString());
+    QCOMPARE(ProxyResolver::configPath(), ProxyResolver::defaultConfigPath());
+    QVERIFY(ProxyResolver::defaultConfigPath().endsWith(QLatin1String("/kioslaverc")));
+}
+
+QTEST_MAIN(proxyResolverTest)
+
+#include "proxyresolvertest.moc"
@@ -0,0 +1,131 @@
+#include <QtTest>
+#include <QtCore>
+
+#include "../src/l10n_dpkgstatus_p.h"
+#include "../src/l10n_sharedcache_p.h"
+
+using Kubuntu::DpkgStatus;
+using Kubuntu::SharedCache;
+
+class sharedCacheTest : public QObject
+{
+    Q_OBJECT
+private slots:
+    void init();
+    void cleanup();
+    void testDisabled();
+    void testRoundTrip();
+    void testStaleKey();
+    void testCorrupt();
+    void testDpkgStatus();
+
+private:
+    QTemporaryDir m_dir;
+};
+
+void sharedCacheTest::init()
+{
+    QVERIFY(m_dir.isValid());
+    SharedCache::setDirectory(m_dir.path());
+}
+
+void sharedCacheTest::cleanup()
+{
+    SharedCache::setDirectory(QString());
+    DpkgStatus::setPath(QString());
+    foreach (const QString &name, QDir(m_dir.path()).entryList(QDir::Files))
+        QFile::remove(m_dir.path() + QLatin1Char('/') + name);
+}
+
+void sharedCacheTest::testDisabled()
+{
+    QVERIFY(SharedCache::isEnabled());
+    SharedCache::setDirectory(m_dir.path() + QLatin1String("/missing"));
+    QVERIFY(!SharedCache::isEnabled());
+    QVERIFY(!SharedCache::write(QLatin1String("test"), "key", "payload"));
+    QVERIFY(!SharedCache::open(QLatin1String("test"), "key"));
+}
+
+void sharedCacheTest::testRoundTrip()
+{
+    const QByteArray payload("the quick brown fox");
+    QVERIFY(SharedCache::write(QLatin1String("test"), "key", payload));
+
+    SharedCache::FilePtr file = SharedCache::open(QLatin1String("test"), "key");
+    QVERIFY(file);
+    QCOMPARE(file->size(), qint64(payload.size()));
+    QCOMPARE(quintptr(file->data()) % 8, quintptr(0));
+    QCOMPARE(QByteArray(reinterpret_cast<const char *>(file->data()), file->size()), payload);
+
+    // Replacing the file does not affect the mapping.
+    QVERIFY(SharedCache::write(QLatin1String("test"), "key", "other"));
+    QCOMPARE(QByteArray(reinterpret_cast<const char *>(file->data()), file->size()), payload);
+}
+
+void sharedCacheTest::testStaleKey()
+{
+    QTemporaryFile source;
+    QVERIFY(source.open());
+    source.write("first");
+    source.flush();
+    const QByteArray key = SharedCache::sourceKey(QStringList() << source.fileName());
+    QVERIFY(SharedCache::write(QLatin1String("test"), key, "payload"));
+    QVERIFY(SharedCache::open(QLatin1String("test"), key));
+
+    source.write(" and second");
+    source.flush();
+    const QByteArray changedKey = SharedCache::sourceKey(QStringList() << source.fileName());
+    QVERIFY(changedKey != key);
+    QVERIFY(!SharedCache::open(QLatin1String("test"), changedKey));
+}
+
+void sharedCacheTest::testCorrupt()
+{
+    QVERIFY(SharedCache::write(QLatin1String("test"), "key", "payload"));
+    QFile file(m_dir.path() + QLatin1String("/test.cache"));
+    QVERIFY(file.exists());
+    QVERIFY(file.resize(file.size() - 1));
+    QVERIFY(!SharedCache::open(QLatin1String("test"), "key"));
+}
+
+void sharedCacheTest::testDpkgStatus()
+{
+    QTemporaryFile temp;
+    QVERIFY2(temp.open(), "opening temporary file failed");
+    temp.write("Package: kde-l10n-de\n"
+               "Status: install ok installed\n"
+               "Version: 4:14.12.1-0ubuntu1\n"
+               "\n"
+               "Package: kde-l10n-fr\n"
+               "Status: deinstall ok config-files\n"
+               "Version: 4:14.12.1-0ubuntu1\n"
+               "\n"
+               "Package: language-pack-de\n"
+               "Status: install ok installed\n"
+               "Version: 1:15.04+20150415\n");
+    temp.close();
+
+    DpkgStatus::setPath(temp.fileName());
+    DpkgStatus::Ptr parsed = DpkgStatus::system();
+    QVERIFY(parsed->isValid());
+    QVERIFY(QFile::exists(m_dir.path() + QLatin1String("/dpkg-status.cache")));
+
+    // Drops the in-process status, the next one comes from the cache file.
+    DpkgStatus::setPath(temp.fileName());
+    DpkgStatus::Ptr cached = DpkgStatus::system();
+    QVERIFY(cached->isValid());
+    QVERIFY(cached != parsed);
+    QCOMPARE(cached->count(), parsed->count());
+    QCOMPARE(cached->lastModified(), parsed->lastModified());
+    foreach (const QString &package, QStringList() << QLatin1String("kde-l10n-de")
+                                                   << QLatin1String("kde-l10n-fr")
+                                                   << QLatin1String("language-pack-de")
+                                                   << QLatin1String("firefox")) {
+        QCOMPARE(cached->isInstalled(package), parsed->isInstalled(package));
+        QCOMPARE(cached->installedVersion(package), parsed->installedVersion(package));
+    }
+}
+
+QTEST_MAIN(sharedCacheTest)
+
+#include "sharedcachetest.moc"
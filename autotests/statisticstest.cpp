@@ -0,0 +1,71 @@
+#include <QtTest>
+#include <QtCore>
+
+#include "../src/l10n_language.h"
+#include "../src/l10n_pkgdepends_p.h"
+#include "../src/l10n_statistics.h"
+
+using Kubuntu::Statistics;
+
+class statisticsTest : public QObject
+{
+    Q_OBJECT
+private slots:
+    void init();
+    void testReset();
+    void testLanguagesCreated();
+    void testPkgDependsLines();
+    void testSnapshotIsDetached();
+};
+
+void statisticsTest::init()
+{
+    Statistics::reset();
+}
+
+void statisticsTest::testReset()
+{
+    Kubuntu::Language l(QLatin1String("de"));
+    QVERIFY(Statistics::snapshot().count(Statistics::LanguagesCreated) > 0);
+    Statistics::reset();
+    const Statistics stats = Statistics::snapshot();
+    for (int i = 0; i < Statistics::CounterCount; ++i) {
+        QCOMPARE(stats.count(static_cast<Statistics::Counter>(i)), quint64(0));
+        QCOMPARE(stats.nsecsElapsed(static_cast<Statistics::Counter>(i)), quint64(0));
+    }
+}
+
+void statisticsTest::testLanguagesCreated()
+{
+    Kubuntu::Language de(QLatin1String("de"));
+    Kubuntu::Language fr(QLatin1String("fr"));
+    Kubuntu::Language de2(QLatin1String("de"));
+    QCOMPARE(Statistics::snapshot().count(Statistics::LanguagesCreated), quint64(3));
+}
+
+void statisticsTest::testPkgDependsLines()
+{
+    QTemporaryFile file;
+    QVERIFY2(file.open(), "opening temporary file failed");
+    file.write("# comment\n"
+               "tr:::language-pack-\n"
+               "tr::firefox:firefox-locale-\n");
+    file.close();
+
+    QVERIFY(Kubuntu::PkgDepends::fromFile(file.fileName())->isValid());
+    const Statistics stats = Statistics::snapshot();
+    QCOMPARE(stats.count(Statistics::PkgDependsLinesParsed), quint64(3));
+    QVERIFY(stats.nsecsElapsed(Statistics::PkgDependsLinesParsed) > 0);
+}
+
+void statisticsTest::testSnapshotIsDetached()
+{
+    const Statistics before = Statistics::snapshot();
+    Kubuntu::Language l(QLatin1String("de"));
+    QCOMPARE(before.count(Statistics::LanguagesCreated), quint64(0));
+    QCOMPARE(Statistics::snapshot().count(Statistics::LanguagesCreated), quint64(1));
+}
+
+QTEST_MAIN(statisticsTest)
+
+#include "statisticstest.moc"
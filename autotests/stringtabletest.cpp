@@ -0,0 +1,73 @@
+#include <QtTest>
+#include <QtCore>
+#include <QtConcurrent>
+
+#include "../src/l10n_stringtable_p.h"
+
+using Kubuntu::StringTable;
+
+class stringTableTest : public QObject
+{
+    Q_OBJECT
+private slots:
+    void testEmpty();
+    void testIntern();
+    void testPackageName();
+    void testConcurrentIntern();
+};
+
+void stringTableTest::testEmpty()
+{
+    QCOMPARE(StringTable::intern(QString()), quint32(StringTable::EmptyId));
+    QCOMPARE(StringTable::intern(QLatin1String("")), quint32(StringTable::EmptyId));
+    QVERIFY(StringTable::string(StringTable::EmptyId).isEmpty());
+}
+
+void stringTableTest::testIntern()
+{
+    const QString string = QLatin1String("stringtabletest-intern");
+    QCOMPARE(StringTable::id(string), quint32(StringTable::EmptyId));
+
+    const int count = StringTable::count();
+    const quint32 id = StringTable::intern(string);
+    QVERIFY(id != StringTable::EmptyId);
+    QCOMPARE(StringTable::count(), count + 1);
+    QCOMPARE(StringTable::intern(string), id);
+    QCOMPARE(StringTable::count(), count + 1);
+    QCOMPARE(StringTable::id(string), id);
+    QCOMPARE(StringTable::string(id), string);
+
+    // Copies share the table's storage.
+    QCOMPARE(StringTable::string(id).constData(), StringTable::string(id).constData());
+
+    QVERIFY(StringTable::string(quint32(-1)).isNull());
+}
+
+void stringTableTest::testPackageName()
+{
+    const quint32 prefix = StringTable::intern(QLatin1String("firefox-locale-"));
+    const quint32 code = StringTable::intern(QLatin1String("pt"));
+    const QString name = StringTable::packageName(prefix, code);
+    QCOMPARE(name, QString("firefox-locale-pt"));
+    QCOMPARE(StringTable::packageName(prefix, code).constData(), name.constData());
+    QCOMPARE(StringTable::packageName(prefix, StringTable::EmptyId), QString("firefox-locale-"));
+}
+
+static quint32 internCommon(int index)
+{
+    return StringTable::intern(QString::fromLatin1("stringtabletest-concurrent-%1").arg(index % 10));
+}
+
+void stringTableTest::testConcurrentIntern()
+{
+    QList<int> indices;
+    for (int i = 0; i < 1000; ++i)
+        indices << i;
+    const QList<quint32> ids = QtConcurrent::blockingMapped(indices, internCommon);
+    for (int i = 0; i < ids.size(); ++i)
+        QCOMPARE(ids.at(i), ids.at(i % 10));
+}
+
+QTEST_MAIN(stringTableTest)
+
+#include "stringtabletest.moc"
@@ -0,0 +1,87 @@
+#include <QtTest>
+#include <QtCore>
+
+#include "../src/l10n_triggerindex.h"
+
+class triggerIndexTest : public QObject
+{
+    Q_OBJECT
+private slots:
+    void initTestCase();
+    void testTriggers();
+    void testPrefixes();
+    void testPackages();
+    void testInvalid();
+
+private:
+    QTemporaryFile m_pkgDepends;
+};
+
+void triggerIndexTest::initTestCase()
+{
+    QVERIFY2(m_pkgDepends.open(), "opening temporary file failed");
+    m_pkgDepends.write("# comment\n"
+                       "tr:::language-pack-\n"
+                       "tr::firefox:firefox-locale-\n"
+                       "tr:de:libreoffice-common:libreoffice-l10n-\n"
+                       "tr:zh-hans:libreoffice-common:libreoffice-l10n-\n"
+                       "tr:zh-hans:libreoffice-common:libreoffice-help-\n"
+                       "in:de:chromium-browser:chromium-browser-l10n\n"
+                       "xx::kate:kate-l10n-\n"
+                       "broken:line\n");
+    m_pkgDepends.close();
+}
+
+void triggerIndexTest::testTriggers()
+{
+    Kubuntu::TriggerIndex index(m_pkgDepends.fileName());
+    QVERIFY(index.isValid());
+
+    QStringList triggers = index.triggers();
+    triggers.sort();
+    QCOMPARE(triggers, QStringList() << "chromium-browser" << "firefox" << "libreoffice-common");
+
+    QVERIFY(index.isTrigger(QLatin1String("firefox")));
+    QVERIFY(!index.isTrigger(QLatin1String("kate"))); // Invalid column.
+    QVERIFY(!index.isTrigger(QString())); // Unconditional rules are no triggers.
+
+    QVERIFY(index.affectsAllLanguages(QLatin1String("firefox")));
+    QVERIFY(!index.affectsAllLanguages(QLatin1String("libreoffice-common")));
+
+    QStringList languages = index.languages(QLatin1String("libreoffice-common"));
+    languages.sort();
+    QCOMPARE(languages, QStringList() << "de" << "zh-hans");
+    QVERIFY(index.languages(QLatin1String("firefox")).isEmpty());
+}
+
+void triggerIndexTest::testPrefixes()
+{
+    Kubuntu::TriggerIndex index(m_pkgDepends.fileName());
+    QCOMPARE(index.prefixes(QLatin1String("libreoffice-common"), QLatin1String("zh-hans")),
+             QStringList() << "libreoffice-l10n-" << "libreoffice-help-");
+    QVERIFY(index.prefixes(QLatin1String("libreoffice-common"), QLatin1String("fr")).isEmpty());
+    QVERIFY(index.prefixes(QLatin1String("gimp"), QLatin1String("fr")).isEmpty());
+}
+
+void triggerIndexTest::testPackages()
+{
+    Kubuntu::TriggerIndex index(m_pkgDepends.fileName());
+    QCOMPARE(index.packages(QLatin1String("firefox"), QLatin1String("de")),
+             QStringList() << "firefox-locale-de");
+    QCOMPARE(index.packages(QLatin1String("firefox"), QLatin1String("zh_CN")),
+             QStringList() << "firefox-locale-zhcn" << "firefox-locale-zh-hans");
+    QCOMPARE(index.packages(QLatin1String("chromium-browser"), QLatin1String("de")),
+             QStringList() << "chromium-browser-l10n");
+    QVERIFY(index.packages(QLatin1String("chromium-browser"), QLatin1String("fr")).isEmpty());
+}
+
+void triggerIndexTest::testInvalid()
+{
+    Kubuntu::TriggerIndex index(QLatin1String("/dev/null/pkg_depends"));
+    QVERIFY(!index.isValid());
+    QVERIFY(index.triggers().isEmpty());
+}
+
+QTEST_MAIN(triggerIndexTest)
+
+#include "triggerindextest.moc"
@@ -0,0 +1,258 @@
+#include <QtTest>
+#include <QtCore>
+#include <QtWidgets>
+
+#include "../src/busyoverlay.h"
+
+using Kubuntu::BusyOverlay;
+
+// Counts paint events of all widgets in the application.
+class PaintCounter : public QObject
+{
+public:
+    PaintCounter() : overlay(nullptr), overlayPaints(0), basePaints(0) {}
+
+    void reset() { overlayPaints = 0; basePaints = 0; }
+    /** \returns the paints of "overlay" or "base" */
+    int paints(const QString &widget) const
+    {
+        return widget == QLatin1String("overlay") ? overlayPaints : basePaints;
+    }
+
+    QWidget *overlay;
+    int overlayPaints;
+    int basePaints;
+
+protected:
+    bool eventFilter(QObject *object, QEvent *event) override
+    {
+        if (event->type() == QEvent::Paint) {
+            QWidget *widget = static_cast<QWidget *>(object);
+            if (overlay && (widget == overlay || overlay->isAncestorOf(widget)))
+                ++overlayPaints;
+            else
+                ++basePaints;
+        }
+        return QObject::eventFilter(object, event);
+    }
+};
+
+class busyOverlayBenchmark : public QObject
+{
+    Q_OBJECT
+private slots:
+    void initTestCase();
+    void init();
+    void cleanup();
+
+    void benchmarkEventFilter();
+    void benchmarkResizeStorm_data();
+    void benchmarkResizeStorm();
+    void benchmarkResizeStormPaints_data();
+    void benchmarkResizeStormPaints();
+    void benchmarkProgressStorm_data();
+    void benchmarkProgressStorm();
+    void benchmarkProgressStormPaints_data();
+    void benchmarkProgressStormPaints();
+
+private:
+    void resizeStorm();
+    void progressStorm();
+
+    PaintCounter m_paints;
+    QWidget *m_base;
+    BusyOverlay *m_overlay;
+};
+
+// Processes everything queued by a storm, including the deferred
+// reposition and the resulting repaints; i.e. renders one frame.
+static void flush()
+{
+    for (int i = 0; i < 3; ++i)
+        QCoreApplication::processEvents();
+}
+
+// Roughly what a KCM page looks like: a form with a few dozen inputs
+// next to a populated item view.
+static QWidget *createBase()
+{
+    QWidget *base = new QWidget;
+    QHBoxLayout *layout = new QHBoxLayout(base);
+
+    QWidget *form = new QWidget(base);
+    QGridLayout *grid = new QGridLayout(form);
+    for (int row = 0; row < 20; ++row) {
+        grid->addWidget(new QLabel(QString::fromLatin1("Option %1").arg(row), form), row, 0);
+        grid->addWidget(new QLineEdit(QString::number(row), form), row, 1);
+        grid->addWidget(new QCheckBox(QLatin1String("Enabled"), form), row, 2);
+        grid->addWidget(new QPushButton(QLatin1String("Configure..."), form), row, 3);
+    }
+    layout->addWidget(form);
+
+    QTreeWidget *tree = new QTreeWidget(base);
+    for (int i = 0; i < 500; ++i)
+        new QTreeWidgetItem(tree, QStringList() << QString::fromLatin1("Item %1").arg(i));
+    layout->addWidget(tree);
+
+    base->resize(1024, 768);
+    return base;
+}
+
+void busyOverlayBenchmark::initTestCase()
+{
+    qApp->installEventFilter(&m_paints);
+}
+
+void busyOverlayBenchmark::init()
+{
+    m_base = createBase();
+    m_base->show();
+    QVERIFY(QTest::qWaitForWindowExposed(m_base));
+    m_overlay = new BusyOverlay(m_base);
+    m_paints.overlay = m_overlay;
+    flush();
+    m_paints.reset();
+}
+
+void busyOverlayBenchmark::cleanup()
+{
+    m_paints.overlay = nullptr;
+    delete m_base;
+}
+
+// Move and resize events as delivered during an interactive window resize.
+void busyOverlayBenchmark::resizeStorm()
+{
+    for (int i = 0; i < 50; ++i)
+        m_base->resize(800 + i * 4, 600 + i * 3);
+}
+
+// Progress as relayed from QApt: creeping up with plenty of repeats.
+void busyOverlayBenchmark::progressStorm()
+{
+    for (int i = 0; i < 1000; ++i)
+        m_overlay->setProgress(i / 10);
+}
+
+void busyOverlayBenchmark::benchmarkEventFilter()
+{
+    QResizeEvent resize(QSize(800, 600), m_base->size());
+    QMoveEvent move(QPoint(10, 10), QPoint(0, 0));
+    QBENCHMARK {
+        for (int i = 0; i < 100; ++i) {
+            QCoreApplication::sendEvent(m_base, &move);
+            QCoreApplication::sendEvent(m_base, &resize);
+        }
+    }
+    flush();
+}
+
+void busyOverlayBenchmark::benchmarkResizeStorm_data()
+{
+    QTest::addColumn<bool>("snapshot");
+    QTest::newRow("translucent") << false;
+    QTest::newRow("snapshot") << true;
+}
+
+void busyOverlayBenchmark::benchmarkResizeStorm()
+{
+    QFETCH(bool, snapshot);
+    m_overlay->setSnapshotEnabled(snapshot);
+    flush();
+    QBENCHMARK {
+        resizeStorm();
+        flush();
+    }
+}
+
+// Overlay and base paints are reported as rows of their own, a sum would
+// hide work moving from one to the other.
+void busyOverlayBenchmark::benchmarkResizeStormPaints_data()
+{
+    QTest::addColumn<bool>("snapshot");
+    QTest::addColumn<QString>("widget");
+    QTest::newRow("translucent, overlay") << false << QString::fromLatin1("overlay");
+    QTest::newRow("translucent, base") << false << QString::fromLatin1("base");
+    QTest::newRow("snapshot, overlay") << true << QString::fromLatin1("overlay");
+    QTest::newRow("snapshot, base") << true << QString::fromLatin1("base");
+}
+
+void busyOverlayBenchmark::benchmarkResizeStormPaints()
+{
+    QFETCH(bool, snapshot);
+    QFETCH(QString, widget);
+    m_overlay->setSnapshotEnabled(snapshot);
+    flush();
+    m_paints.reset();
+    resizeStorm();
+    flush();
+    QTest::setBenchmarkResult(m_paints.paints(widget), QTest::Events);
+}
+
+void busyOverlayBenchmark::benchmarkProgressStorm_data()
+{
+    QTest::addColumn<int>("rate");
+    QTest::addColumn<bool>("snapshot");
+    QTest::newRow("unlimited, translucent") << 0 << false;
+    QTest::newRow("unlimited, snapshot") << 0 << true;
+    QTest::newRow("30/s, translucent") << 30 << false;
+    QTest::newRow("30/s, snapshot") << 30 << true;
+}
+
+void busyOverlayBenchmark::benchmarkProgressStorm()
+{
+    QFETCH(int, rate);
+    QFETCH(bool, snapshot);
+    m_overlay->setMaximumProgressRate(rate);
+    m_overlay->setSnapshotEnabled(snapshot);
+    flush();
+    QBENCHMARK {
+        m_overlay->setProgress(0);
+        progressStorm();
+        flush();
+    }
+}
+
+void busyOverlayBenchmark::benchmarkProgressStormPaints_data()
+{
+    QTest::addColumn<int>("rate");
+    QTest::addColumn<bool>("snapshot");
+    QTest::addColumn<QString>("widget");
+    QTest::newRow("unlimited, translucent, overlay") << 0 << false << QString::fromLatin1("overlay");
+    QTest::newRow("unlimited, translucent, base") << 0 << false << QString::fromLatin1("base");
+    QTest::newRow("unlimited, snapshot, overlay") << 0 << true << QString::fromLatin1("overlay");
+    QTest::newRow("unlimited, snapshot, base") << 0 << true << QString::fromLatin1("base");
+    QTest::newRow("30/s, translucent, overlay") << 30 << false << QString::fromLatin1("overlay");
+    QTest::newRow("30/s, translucent, base") << 30 << false << QString::fromLatin1("base");
+    QTest::newRow("30/s, snapshot, overlay") << 30 << true << QString::fromLatin1("overlay");
+    QTest::newRow("30/s, snapshot, base") << 30 << true << QString::fromLatin1("base");
+}
+
+void busyOverlayBenchmark::benchmarkProgressStormPaints()
+{
+    QFETCH(int, rate);
+    QFETCH(bool, snapshot);
+    QFETCH(QString, widget);
+    m_overlay->setMaximumProgressRate(rate);
+    m_overlay->setSnapshotEnabled(snapshot);
+    flush();
+    m_paints.reset();
+    progressStorm();
+    // Includes the trailing update held back by the rate limit.
+    QTest::qWait(100);
+    QTest::setBenchmarkResult(m_paints.paints(widget), QTest::Events);
+}
+
+int main(int argc, char **argv)
+{
+    // Runs on headless build machines, any other platform may still be
+    // picked explicitly.
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+
+    QApplication app(argc, argv);
+    busyOverlayBenchmark benchmark;
+    return QTest::qExec(&benchmark, argc, argv);
+}
+
+#include "busyoverlaybenchmark.moc"
@@ -0,0 +1,96 @@
+#!/bin/sh
+#
+# Copyright (C) 2015 Harald Sitter <sitter@kde.org>
+#
+# This library is free software; you can redistribute it and/or
+# modify it under the terms of the GNU Lesser General Public
+# License as published by the Free Software Foundation; either
+# version 2.1 of the License, or (at your option) version 3, or any
+# later version accepted by the membership of KDE e.V. (or its
+# successor approved by the membership of KDE e.V.), which shall
+# act as a proxy defined in Section 6 of version 3 of the license.
+#
+# This library is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with this library.  If not, see <http://www.gnu.org/licenses/>.
+
+# Generates a throwaway file:// APT repository of empty dummy packages plus a
+# matching pkg_depends for installbenchmark.
+#
+# Installs go through the QApt worker, which always operates on the system
+# APT configuration and can not be pointed at a chroot. Only ever enable the
+# repository in a disposable container or VM.
+#
+# Usage: generate-apt-repository.sh <directory>
+
+set -e
+
+if [ -z "$1" ]; then
+    echo "Usage: $0 <directory>" >&2
+    exit 1
+fi
+
+for tool in dpkg-deb apt-ftparchive; do
+    if ! command -v $tool > /dev/null; then
+        echo "$tool is required" >&2
+        exit 1
+    fi
+done
+
+mkdir -p "$1"
+repo=$(cd "$1" && pwd)
+build=$(mktemp -d)
+trap 'rm -rf "$build"' EXIT
+
+# Language codes and the number of language specific packages each needs,
+# installbenchmark uses one language per batch size.
+batches="bench1:1 bench10:10 bench50:50"
+
+package() {
+    mkdir -p "$build/$1/DEBIAN"
+    cat > "$build/$1/DEBIAN/control" <<CONTROL
+Package: $1
+Version: 1.0
+Architecture: all
+Maintainer: libkubuntu benchmarks <kubuntu-devel@lists.ubuntu.com>
+Description: libkubuntu install benchmark dummy
+CONTROL
+    dpkg-deb --build "$build/$1" "$repo/$1_1.0_all.deb" > /dev/null
+}
+
+: > "$repo/pkg_depends"
+package l10nbench-trigger
+echo "tr::l10nbench-trigger:l10nbench-triggered-" >> "$repo/pkg_depends"
+echo "tr:::kde-l10n-" >> "$repo/pkg_depends"
+echo "tr:::language-pack-" >> "$repo/pkg_depends"
+
+for batch in $batches; do
+    code=${batch%%:*}
+    count=${batch##*:}
+    package kde-l10n-$code
+    package language-pack-$code
+    package l10nbench-triggered-$code
+    i=0
+    while [ $i -lt $count ]; do
+        package l10nbench-$i-$code
+        echo "tr:$code::l10nbench-$i-" >> "$repo/pkg_depends"
+        i=$((i + 1))
+    done
+done
+
+(cd "$repo" && apt-ftparchive packages . > Packages)
+
+cat <<INSTRUCTIONS
+Repository written to $repo
+
+In a disposable container or VM run as root:
+  echo 'deb [trusted=yes] file://$repo ./' > /etc/apt/sources.list.d/l10nbench.list
+  apt-get update && apt-get install l10nbench-trigger
+
+Then run the benchmark:
+  KUBUNTU_BENCHMARK_APT_REPOSITORY=$repo ./installbenchmark
+INSTRUCTIONS
@@ -0,0 +1,116 @@
+#include <QtTest>
+#include <QtCore>
+
+#include <QApt/Backend>
+#include <QApt/Transaction>
+
+#include "../src/l10n_language.h"
+#include "../src/l10n_pkgdepends_p.h"
+
+// Full completeSupport cycles against the repository written by
+// generate-apt-repository.sh. Skipped unless KUBUNTU_BENCHMARK_APT_REPOSITORY
+// points at it, as this installs and removes packages on the system.
+class installBenchmark : public QObject
+{
+    Q_OBJECT
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void cleanup();
+
+    void benchmarkReloadCache();
+    void benchmarkCompleteSupport_data();
+    void benchmarkCompleteSupport();
+
+private:
+    QApt::Backend m_backend;
+    QStringList m_installed;
+};
+
+void installBenchmark::initTestCase()
+{
+    const QString repository = QString::fromLocal8Bit(qgetenv("KUBUNTU_BENCHMARK_APT_REPOSITORY"));
+    if (repository.isEmpty())
+        QSKIP("KUBUNTU_BENCHMARK_APT_REPOSITORY not set, see generate-apt-repository.sh");
+
+    Kubuntu::PkgDepends::setPath(repository + QLatin1String("/pkg_depends"));
+    QVERIFY(Kubuntu::PkgDepends::system()->isValid());
+
+    QVERIFY(m_backend.init());
+    QApt::Package *trigger = m_backend.package(QLatin1String("l10nbench-trigger"));
+    QVERIFY2(trigger && trigger->isInstalled(), "l10nbench-trigger must be installed");
+}
+
+void installBenchmark::cleanupTestCase()
+{
+    Kubuntu::PkgDepends::setPath(QString());
+}
+
+void installBenchmark::cleanup()
+{
+    // Put the system back so every run installs the same set of packages.
+    if (m_installed.isEmpty())
+        return;
+
+    m_backend.reloadCache();
+    QApt::PackageList packages;
+    foreach (const QString &name, m_installed) {
+        if (QApt::Package *package = m_backend.package(name))
+            packages.append(package);
+    }
+    m_installed.clear();
+    m_backend.markPackages(packages, QApt::Package::ToRemove);
+
+    QApt::Transaction *transaction = m_backend.commitChanges();
+    QVERIFY(transaction);
+    QEventLoop loop;
+    connect(transaction, SIGNAL(finished(QApt::ExitStatus)), &loop, SLOT(quit()));
+    transaction->run();
+    loop.exec();
+    m_backend.reloadCache();
+}
+
+void installBenchmark::benchmarkReloadCache()
+{
+    QBENCHMARK {
+        m_backend.reloadCache();
+    }
+}
+
+void installBenchmark::benchmarkCompleteSupport_data()
+{
+    // Language code and the number of packages generate-apt-repository.sh
+    // makes it miss: kde-l10n, language-pack, the triggered one and the
+    // language specific ones.
+    QTest::addColumn<QString>("code");
+    QTest::addColumn<int>("packages");
+    QTest::newRow("4 packages") << QString::fromLatin1("bench1") << 4;
+    QTest::newRow("13 packages") << QString::fromLatin1("bench10") << 13;
+    QTest::newRow("53 packages") << QString::fromLatin1("bench50") << 53;
+}
+
+void installBenchmark::benchmarkCompleteSupport()
+{
+    QFETCH(QString, code);
+    QFETCH(int, packages);
+
+    Kubuntu::Language language(code);
+    QVERIFY(!language.isSupportComplete());
+    m_installed = language.missingPackages();
+    QCOMPARE(m_installed.size(), packages);
+
+    QSignalSpy completeSpy(&language, SIGNAL(supportComplete()));
+    QSignalSpy failedSpy(&language, SIGNAL(supportCompletionFailed()));
+    // Mark, commit, transaction run and cache reload; installs can not be
+    // repeated without removing again, so this is measured once per run.
+    QBENCHMARK_ONCE {
+        language.completeSupport();
+        QVERIFY(completeSpy.wait(5 * 60 * 1000));
+    }
+    QCOMPARE(failedSpy.count(), 0);
+    QVERIFY(language.isSupportComplete());
+}
+
+QTEST_MAIN(installBenchmark)
+
+#include "installbenchmark.moc"
@@ -0,0 +1,290 @@
+#include <QtTest>
+#include <QtCore>
+
+#include "../src/l10n_language.h"
+#include "../src/l10n_languagecollection.h"
+#include "../src/l10n_locale.h"
+#include "../src/l10n_memorypackageprovider_p.h"
+#include "../src/l10n_pkgdepends_p.h"
+
+// Ubuntu package codes used in the language column of synthetic pkg_depends.
+static const char *s_ubuntuCodes[] = { "de", "fr", "es", "pt", "zh-hans", 0 };
+
+class l10nBenchmark : public QObject
+{
+    Q_OBJECT
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void benchmarkUbuntuPackageCodeForKdeCode_data();
+    void benchmarkUbuntuPackageCodeForKdeCode();
+    void benchmarkKdeLanguageCodeForKdePackageCode_data();
+    void benchmarkKdeLanguageCodeForKdePackageCode();
+    void benchmarkKdePackageCodeForKdeLanguageCode_data();
+    void benchmarkKdePackageCodeForKdeLanguageCode();
+    void benchmarkSystemLanguageCode();
+
+    void benchmarkLocaleConstruction_data();
+    void benchmarkLocaleConstruction();
+    void benchmarkSystemLocaleString();
+    void benchmarkSystemLanguagesString();
+
+    void benchmarkPkgDependsParse_data();
+    void benchmarkPkgDependsParse();
+    void benchmarkIsSupportComplete_data();
+    void benchmarkIsSupportComplete();
+
+    void benchmarkCollectionLanguages();
+    void benchmarkCollectionCheckSupport();
+
+private:
+    QString pkgDependsPath(int lines);
+
+    QTemporaryDir m_dir;
+    Kubuntu::MemoryPackageProvider m_provider;
+};
+
+// Writes a pkg_depends with a realistic mix of unconditional, triggered
+// and language specific rules as well as noise.
+static bool writePkgDepends(const QString &path, int lines)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        return false;
+
+    QByteArray buffer;
+    for (int i = 0; i < lines; ++i) {
+        const QByteArray n = QByteArray::number(i);
+        const QByteArray code = s_ubuntuCodes[i % 5];
+        switch (i % 10) {
+        case 0:
+            buffer += "tr:::synthetic-pack-" + n + "-\n";
+            break;
+        case 1:
+        case 2:
+        case 3:
+        case 4:
+            buffer += "tr::synthetic-app-" + n + ":synthetic-app-" + n + "-l10n-\n";
+            break;
+        case 5:
+        case 6:
+        case 7:
+            buffer += "tr:" + code + ":synthetic-app-" + n + ":synthetic-app-" + n + "-help-\n";
+            break;
+        case 8:
+            buffer += "in:" + code + "::synthetic-meta-" + n + "\n";
+            break;
+        default:
+            buffer += "# synthetic noise\n";
+            break;
+        }
+        if (buffer.size() > 1024 * 1024) {
+            file.write(buffer);
+            buffer.clear();
+        }
+    }
+    file.write(buffer);
+    return true;
+}
+
+// Every other synthetic app is installed, all localization packages of the
+// first 100k apps are available. Also provides 100 kde-l10n packages for
+// the collection.
+static void populateProvider(Kubuntu::MemoryPackageProvider *provider)
+{
+    for (int i = 0; i < 100000; ++i) {
+        const QString app = QLatin1String("synthetic-app-") + QString::number(i);
+        provider->addPackage(app, i % 2);
+        for (int code = 0; s_ubuntuCodes[code]; ++code) {
+            provider->addPackage(app + QLatin1String("-l10n-") + QLatin1String(s_ubuntuCodes[code]));
+            provider->addPackage(app + QLatin1String("-help-") + QLatin1String(s_ubuntuCodes[code]));
+        }
+    }
+    for (int i = 0; i < 100; ++i)
+        provider->addPackage(QString::fromLatin1("kde-l10n-xx%1").arg(i));
+}
+
+void l10nBenchmark::initTestCase()
+{
+    QVERIFY(m_dir.isValid());
+    populateProvider(&m_provider);
+    Kubuntu::PackageProvider::setDefaultProvider(&m_provider);
+}
+
+void l10nBenchmark::cleanupTestCase()
+{
+    Kubuntu::PackageProvider::setDefaultProvider(nullptr);
+    Kubuntu::PkgDepends::setPath(QString());
+}
+
+QString l10nBenchmark::pkgDependsPath(int lines)
+{
+    const QString path = m_dir.path() + QLatin1String("/pkg_depends-") + QString::number(lines);
+    if (!QFile::exists(path))
+        writePkgDepends(path, lines);
+    return path;
+}
+
+static void addCodeRows()
+{
+    QTest::addColumn<QString>("code");
+    QTest::newRow("mapped") << QString::fromLatin1("zh_TW");
+    QTest::newRow("unmapped") << QString::fromLatin1("de");
+}
+
+void l10nBenchmark::benchmarkUbuntuPackageCodeForKdeCode_data()
+{
+    addCodeRows();
+}
+
+void l10nBenchmark::benchmarkUbuntuPackageCodeForKdeCode()
+{
+    QFETCH(QString, code);
+    QBENCHMARK {
+        Kubuntu::Language::ubuntuPackageCodeForKdeCode(code);
+    }
+}
+
+void l10nBenchmark::benchmarkKdeLanguageCodeForKdePackageCode_data()
+{
+    QTest::addColumn<QString>("code");
+    QTest::newRow("mapped") << QString::fromLatin1("zhtw");
+    QTest::newRow("unmapped") << QString::fromLatin1("de");
+}
+
+void l10nBenchmark::benchmarkKdeLanguageCodeForKdePackageCode()
+{
+    QFETCH(QString, code);
+    QBENCHMARK {
+        Kubuntu::Language::kdeLanguageCodeForKdePackageCode(code);
+    }
+}
+
+void l10nBenchmark::benchmarkKdePackageCodeForKdeLanguageCode_data()
+{
+    addCodeRows();
+}
+
+void l10nBenchmark::benchmarkKdePackageCodeForKdeLanguageCode()
+{
+    QFETCH(QString, code);
+    QBENCHMARK {
+        Kubuntu::Language::kdePackageCodeForKdeLanguageCode(code);
+    }
+}
+
+void l10nBenchmark::benchmarkSystemLanguageCode()
+{
+    Kubuntu::Language language(QLatin1String("ca@valencia"));
+    QBENCHMARK {
+        language.systemLanguageCode();
+    }
+}
+
+void l10nBenchmark::benchmarkLocaleConstruction_data()
+{
+    QTest::addColumn<QStringList>("codes");
+    QTest::newRow("1 language") << (QStringList() << "de");
+    QTest::newRow("5 languages") << (QStringList() << "ca@valencia" << "de" << "en_GB" << "zh_TW" << "de");
+    QStringList many;
+    for (int i = 0; i < 20; ++i)
+        many << QString::fromLatin1("xx_%1").arg(i);
+    QTest::newRow("20 languages") << many;
+}
+
+void l10nBenchmark::benchmarkLocaleConstruction()
+{
+    QFETCH(QStringList, codes);
+    QBENCHMARK {
+        Kubuntu::Locale locale(codes, QLatin1String("AT"));
+    }
+}
+
+void l10nBenchmark::benchmarkSystemLocaleString()
+{
+    Kubuntu::Locale locale(QList<QString>() << "ca@valencia" << "de", QLatin1String("ES"));
+    QBENCHMARK {
+        locale.systemLocaleString();
+    }
+}
+
+void l10nBenchmark::benchmarkSystemLanguagesString()
+{
+    Kubuntu::Locale locale(QList<QString>() << "zh_CN" << "zh_TW" << "de" << "en_GB" << "fr",
+                           QLatin1String("US"));
+    QBENCHMARK {
+        locale.systemLanguagesString();
+    }
+}
+
+static void addLineRows()
+{
+    QTest::addColumn<int>("lines");
+    QTest::newRow("1k lines") << 1000;
+    QTest::newRow("10k lines") << 10000;
+    QTest::newRow("100k lines") << 100000;
+    QTest::newRow("1M lines") << 1000000;
+}
+
+void l10nBenchmark::benchmarkPkgDependsParse_data()
+{
+    addLineRows();
+}
+
+void l10nBenchmark::benchmarkPkgDependsParse()
+{
+    QFETCH(int, lines);
+    const QString path = pkgDependsPath(lines);
+    QBENCHMARK {
+        Kubuntu::PkgDepends::fromFile(path);
+    }
+}
+
+void l10nBenchmark::benchmarkIsSupportComplete_data()
+{
+    addLineRows();
+}
+
+void l10nBenchmark::benchmarkIsSupportComplete()
+{
+    QFETCH(int, lines);
+    Kubuntu::PkgDepends::setPath(pkgDependsPath(lines));
+
+    // en_US has no language specific rules and none of its packages exist,
+    // so nothing ever ends up missing and every call evaluates all rules.
+    // The first call pays for parsing, keep it out of the measurement.
+    Kubuntu::Language language(QLatin1String("en_US"));
+    QVERIFY(language.isSupportComplete());
+    QBENCHMARK {
+        language.isSupportComplete();
+    }
+}
+
+void l10nBenchmark::benchmarkCollectionLanguages()
+{
+    Kubuntu::LanguageCollection collection;
+    QCOMPARE(collection.languages().size(), 101); // Including the injected en_US.
+    QBENCHMARK {
+        collection.languages();
+    }
+}
+
+void l10nBenchmark::benchmarkCollectionCheckSupport()
+{
+    Kubuntu::PkgDepends::setPath(pkgDependsPath(10000));
+
+    Kubuntu::LanguageCollection collection;
+    const QSet<Kubuntu::Language *> languages = collection.languages();
+    QEventLoop loop;
+    connect(&collection, SIGNAL(supportChecked(QSet<Kubuntu::Language*>)),
+            &loop, SLOT(quit()));
+    QBENCHMARK {
+        collection.checkSupport(languages);
+        loop.exec();
+    }
+}
+
+QTEST_MAIN(l10nBenchmark)
+
+#include "l10nbenchmark.moc"
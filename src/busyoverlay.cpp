@@ -21,17 +21,75 @@
 #include "busyoverlay.h"
 #include "ui_busyoverlay.h"
 
+#include <QElapsedTimer>
+#include <QHash>
+#include <QPainter>
+#include <QTimer>
+
 namespace Kubuntu {
 
+/** Forwards signals of a sender to one named progress source. */
+class BusyOverlaySource : public QObject
+{
+    Q_OBJECT
+public:
+    BusyOverlaySource(const QString &name, BusyOverlay *overlay)
+        : QObject(overlay)
+        , m_name(name)
+        , m_overlay(overlay)
+    {}
+
+public slots:
+    void setProgress(int percent) { m_overlay->setSourceProgress(m_name, percent); }
+    void finish() { m_overlay->finishProgressSource(m_name); }
+
+private:
+    const QString m_name;
+    BusyOverlay *const m_overlay;
+};
+
 class BusyOverlayPrivate
 {
 public:
     BusyOverlayPrivate(BusyOverlay *q, QWidget *baseWidget);
 
+    /** Schedules a reposition for the next event loop pass, unless one is pending. */
+    void scheduleReposition();
     void reposition();
+    /** Shows the most recently set progress value. */
+    void updateProgressBar();
+    /** Grabs and dims the base widget if snapshots are enabled. */
+    void updateSnapshot();
+    /** Switches between translucent and opaque snapshot painting. */
+    void updateBackground();
+    /** Shows the combined progress of all sources or throws the overlay away. */
+    void updateSourceProgress();
 
     QScopedPointer<Ui::BusyOverlay> ui;
     QWidget *baseWidget;
+    // Moves and resizes of the base arrive in bursts while a window is
+    // dragged or resized, coalesce them into one reposition.
+    QTimer repositionTimer;
+
+    // Progress arrives straight from QApt and xapian, often many times per
+    // frame and with repeated values. Only the latest value is kept and
+    // the bar is updated at most maximumProgressRate times per second.
+    int progress;
+    int maximumProgressRate;
+    QElapsedTimer progressUpdated;
+    QTimer progressTimer;
+
+    bool snapshotEnabled;
+    QPixmap snapshot;
+    QSize snapshotSize;
+
+    struct Source {
+        Source(qreal weight = 1.0) : weight(weight), progress(0), finished(false) {}
+        qreal weight;
+        int progress;
+        bool finished;
+    };
+    QHash<QString, Source> sources;
 
 private:
     BusyOverlay *const q_ptr;
@@ -43,6 +101,9 @@ private:
 BusyOverlayPrivate::BusyOverlayPrivate(BusyOverlay *q, QWidget *baseWidget)
     : ui(new Ui::BusyOverlay)
     , baseWidget(baseWidget)
+    , progress(0)
+    , maximumProgressRate(30)
+    , snapshotEnabled(false)
     , q_ptr(q)
 {
     ui->setupUi(q);
@@ -50,13 +111,27 @@ BusyOverlayPrivate::BusyOverlayPrivate(BusyOverlay *q, QWidget *baseWidget)
     ui->progressBar->setMaximum(100);
     ui->progressBar->setValue(0);
 
+    repositionTimer.setSingleShot(true);
+    repositionTimer.setInterval(0);
+    q->connect(&repositionTimer, SIGNAL(timeout()), q, SLOT(reposition()));
+
+    progressTimer.setSingleShot(true);
+    q->connect(&progressTimer, SIGNAL(timeout()), q, SLOT(updateProgressBar()));
+
     baseWidget->setEnabled(false);
     baseWidget->installEventFilter(q);
 }
 
+void BusyOverlayPrivate::scheduleReposition()
+{
+    if (!repositionTimer.isActive())
+        repositionTimer.start();
+}
+
 void BusyOverlayPrivate::reposition()
 {
     Q_Q(BusyOverlay);
+    repositionTimer.stop();
     if (!baseWidget->isVisible()) {
         q->hide();
         return;
@@ -69,6 +144,72 @@ void BusyOverlayPrivate::reposition()
 
     QSize baseSize = baseWidget->size();
     q->resize(baseSize);
+
+    if (snapshotEnabled && baseSize != snapshotSize)
+        updateSnapshot();
+}
+
+void BusyOverlayPrivate::updateProgressBar()
+{
+    progressTimer.stop();
+    progressUpdated.start();
+    if (ui->progressBar->value() != progress)
+        ui->progressBar->setValue(progress);
+}
+
+void BusyOverlayPrivate::updateSnapshot()
+{
+    Q_Q(BusyOverlay);
+    snapshot = QPixmap();
+    snapshotSize = QSize();
+    if (snapshotEnabled && baseWidget->isVisible()) {
+        // The overlay is usually a child of the base and must not end up
+        // in its own background.
+        const bool hideOverlay = q->isVisible() && baseWidget->isAncestorOf(q);
+        if (hideOverlay)
+            q->hide();
+        snapshot = baseWidget->grab();
+        if (hideOverlay)
+            q->show();
+
+        QPainter painter(&snapshot);
+        painter.fillRect(QRect(QPoint(0, 0), baseWidget->size()),
+                         q->palette().color(q->backgroundRole()));
+        snapshotSize = baseWidget->size();
+    }
+    updateBackground();
+    q->update();
+}
+
+void BusyOverlayPrivate::updateBackground()
+{
+    Q_Q(BusyOverlay);
+    // Only claim to be opaque while there is a snapshot to paint, otherwise
+    // fall back to the translucent background.
+    const bool opaque = !snapshot.isNull();
+    q->setAutoFillBackground(!opaque);
+    q->setAttribute(Qt::WA_OpaquePaintEvent, opaque);
+}
+
+void BusyOverlayPrivate::updateSourceProgress()
+{
+    Q_Q(BusyOverlay);
+    qreal totalWeight = 0;
+    qreal weightedProgress = 0;
+    bool finished = true;
+    foreach (const Source &source, sources) {
+        totalWeight += source.weight;
+        weightedProgress += source.weight * (source.finished ? 100 : source.progress);
+        finished = finished && source.finished;
+    }
+
+    if (finished) {
+        q->throwAway();
+        return;
+    }
+    // Goes through the rate limit like any other progress value, so the
+    // number of sources does not increase the number of repaints.
+    q->setProgress(totalWeight > 0 ? qRound(weightedProgress / totalWeight) : 0);
 }
 
 BusyOverlay::BusyOverlay(QWidget *baseWidget, QWidget *parent)
@@ -92,10 +233,76 @@ BusyOverlay::~BusyOverlay()
 {
 }
 
+void BusyOverlay::setMaximumProgressRate(int updatesPerSecond)
+{
+    Q_D(BusyOverlay);
+    d->maximumProgressRate = qMax(0, updatesPerSecond);
+    if (d->progressTimer.isActive())
+        d->updateProgressBar();
+}
+
+int BusyOverlay::maximumProgressRate() const
+{
+    Q_D(const BusyOverlay);
+    return d->maximumProgressRate;
+}
+
+void BusyOverlay::setSnapshotEnabled(bool enabled)
+{
+    Q_D(BusyOverlay);
+    if (d->snapshotEnabled == enabled)
+        return;
+    d->snapshotEnabled = enabled;
+    d->updateSnapshot();
+}
+
+bool BusyOverlay::isSnapshotEnabled() const
+{
+    Q_D(const BusyOverlay);
+    return d->snapshotEnabled;
+}
+
+void BusyOverlay::addProgressSource(const QString &name, qreal weight)
+{
+    Q_D(BusyOverlay);
+    d->sources.insert(name, BusyOverlayPrivate::Source(qMax(weight, qreal(0))));
+    d->updateSourceProgress();
+}
+
+void BusyOverlay::addProgressSource(const QString &name, QObject *sender,
+                                    const char *progressSignal, const char *finishedSignal,
+                                    qreal weight)
+{
+    addProgressSource(name, weight);
+
+    BusyOverlaySource *source = new BusyOverlaySource(name, this);
+    connect(sender, progressSignal, source, SLOT(setProgress(int)));
+    connect(sender, finishedSignal, source, SLOT(finish()));
+    connect(sender, SIGNAL(destroyed()), source, SLOT(finish()));
+}
+
 void BusyOverlay::setProgress(int percent)
 {
     Q_D(BusyOverlay);
-    d->ui->progressBar->setValue(percent);
+    if (percent == d->progress)
+        return;
+    d->progress = percent;
+
+    if (d->maximumProgressRate <= 0 ||
+            percent >= d->ui->progressBar->maximum() ||
+            !d->progressUpdated.isValid()) {
+        d->updateProgressBar();
+        return;
+    }
+
+    const qint64 interval = 1000 / d->maximumProgressRate;
+    const qint64 elapsed = d->progressUpdated.elapsed();
+    if (elapsed >= interval) {
+        d->updateProgressBar();
+    } else if (!d->progressTimer.isActive()) {
+        // Deliver the latest value once the interval has passed.
+        d->progressTimer.start(interval - elapsed);
+    }
 }
 
 void BusyOverlay::throwAway()
@@ -104,6 +311,28 @@ void BusyOverlay::throwAway()
     deleteLater();
 }
 
+void BusyOverlay::setSourceProgress(const QString &name, int percent)
+{
+    Q_D(BusyOverlay);
+    QHash<QString, BusyOverlayPrivate::Source>::iterator it = d->sources.find(name);
+    if (it == d->sources.end())
+        it = d->sources.insert(name, BusyOverlayPrivate::Source());
+    else if (it->finished || it->progress == percent)
+        return;
+    it->progress = percent;
+    d->updateSourceProgress();
+}
+
+void BusyOverlay::finishProgressSource(const QString &name)
+{
+    Q_D(BusyOverlay);
+    QHash<QString, BusyOverlayPrivate::Source>::iterator it = d->sources.find(name);
+    if (it == d->sources.end() || it->finished)
+        return;
+    it->finished = true;
+    d->updateSourceProgress();
+}
+
 bool BusyOverlay::eventFilter(QObject * object, QEvent * event)
 {
     Q_D(BusyOverlay);
@@ -117,9 +346,23 @@ bool BusyOverlay::eventFilter(QObject * object, QEvent * event)
         if (event->type() == QEvent::Show) {
             show(); // force a show when the base is shown
         }
-        d->reposition();
+        d->scheduleReposition();
     }
     return QWidget::eventFilter(object, event);
 }
 
+void BusyOverlay::paintEvent(QPaintEvent *event)
+{
+    Q_D(BusyOverlay);
+    if (d->snapshot.isNull()) {
+        QWidget::paintEvent(event);
+        return;
+    }
+    QPainter painter(this);
+    painter.drawPixmap(0, 0, d->snapshot);
+}
+
 } // namespace Kubuntu
+
+#include "moc_busyoverlay.cpp"
+#include "busyoverlay.moc"
@@ -38,6 +38,10 @@ class BusyOverlayPrivate;
  * it with the base and sets up a suitable connection for setProgress and throwAway.
  * Everything else is handled by the overlay automatically. It will also take
  * care of deleting itself again.
+ *
+ * To cover multiple operations at once, register each as a progress source
+ * through addProgressSource instead. Their weighted progress is combined into
+ * the one bar and the overlay throws itself away once all of them finished.
  */
 class KUBUNTU_EXPORT BusyOverlay : public QWidget
 {
@@ -57,6 +61,56 @@ public:
     explicit BusyOverlay(QWidget *baseWidget, QWidget *parent = 0);
     virtual ~BusyOverlay();
 
+    /**
+     * Limits how often per second the progress bar repaints. Values arriving
+     * in between are collapsed into the most recent one, which is shown once
+     * the interval passed. 100% is always shown right away.
+     * Defaults to 30.
+     * \param updatesPerSecond maximum repaints per second, 0 for no limit
+     */
+    void setMaximumProgressRate(int updatesPerSecond);
+
+    /** \returns maximum progress repaints per second \see setMaximumProgressRate */
+    int maximumProgressRate() const;
+
+    /**
+     * Enables snapshot rendering. Instead of blending the translucent
+     * overlay onto the live base widget on every repaint, the base is
+     * grabbed once, dimmed and the resulting pixmap painted. Widgets
+     * underneath then no longer repaint along with the overlay, which is
+     * considerably cheaper for complex bases and software rendering.
+     * The snapshot is only renewed when the base is resized, so changes of
+     * the base's content are not visible while the overlay is shown.
+     * Disabled by default.
+     */
+    void setSnapshotEnabled(bool enabled);
+
+    /** \returns \c true if snapshot rendering is used \see setSnapshotEnabled */
+    bool isSnapshotEnabled() const;
+
+    /**
+     * Registers a progress source. The bar shows the weighted average of all
+     * sources, finished sources count as 100%. Once every source finished
+     * the overlay is thrown away.
+     * \param name unique name of the source \see setSourceProgress
+     * \param weight share of the source in the total progress
+     */
+    void addProgressSource(const QString &name, qreal weight = 1.0);
+
+    /**
+     * Registers a progress source driven by signals of \p sender, e.g.
+     * \code
+     * overlay->addProgressSource("update", collection,
+     *                            SIGNAL(updateProgress(int)), SIGNAL(updated()));
+     * \endcode
+     * The source also finishes when \p sender is destroyed.
+     * \param progressSignal signal with the progress (0-100) as first argument
+     * \param finishedSignal signal emitted when the operation is done
+     */
+    void addProgressSource(const QString &name, QObject *sender,
+                           const char *progressSignal, const char *finishedSignal,
+                           qreal weight = 1.0);
+
 public slots:
     /** \param percent Set busy progress to percent (0-100) */
     void setProgress(int percent);
@@ -64,12 +118,24 @@ public slots:
     /** Discards the BusyOverlay. This results in hide() and deleteLater() */
     void throwAway();
 
+    /**
+     * \param name progress source, registered with weight 1 if unknown
+     * \param percent progress of the source (0-100)
+     */
+    void setSourceProgress(const QString &name, int percent);
+
+    /** Marks the progress source \p name as done \see addProgressSource */
+    void finishProgressSource(const QString &name);
+
 protected:
     bool eventFilter(QObject *object, QEvent *event) final override;
+    void paintEvent(QPaintEvent *event) final override;
 
 private:
     const QScopedPointer<BusyOverlayPrivate> d_ptr;
     Q_DECLARE_PRIVATE(BusyOverlay)
+    Q_PRIVATE_SLOT(d_func(), void reposition())
+    Q_PRIVATE_SLOT(d_func(), void updateProgressBar())
 };
 
 } // namespace Kubuntu
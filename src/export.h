@@ -45,6 +45,19 @@
 # endif
 #endif
 
+/**
+ * Exports private classes for autotests and benchmarks, which link the shared
+ * library. Only in effect when those are built; such symbols are not part of
+ * the ABI.
+ */
+#ifndef KUBUNTU_TESTS_EXPORT
+# ifdef KUBUNTU_BUILD_TESTING
+#  define KUBUNTU_TESTS_EXPORT KUBUNTU_EXPORT
+# else
+#  define KUBUNTU_TESTS_EXPORT
+# endif
+#endif
+
 #ifndef KUBUNTU_DEPRECATED
 # define KUBUNTU_DEPRECATED Q_DECL_DEPRECATED
 #endif
@@ -0,0 +1,86 @@
+/*
+  Copyright (C) 2015 Harald Sitter <sitter@kde.org>
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) version 3, or any
+  later version accepted by the membership of KDE e.V. (or its
+  successor approved by the membership of KDE e.V.), which shall
+  act as a proxy defined in Section 6 of version 3 of the license.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef L10N_DEBUG_P_H
+#define L10N_DEBUG_P_H
+
+#include <QElapsedTimer>
+#include <QLoggingCategory>
+
+#include "l10n_statistics_p.h"
+
+// All categories only log warnings unless enabled through QT_LOGGING_RULES,
+// e.g. QT_LOGGING_RULES="kubuntu.l10n.*.debug=true".
+Q_DECLARE_LOGGING_CATEGORY(KUBUNTU_L10N_COLLECTION)
+Q_DECLARE_LOGGING_CATEGORY(KUBUNTU_L10N_LANGUAGE)
+Q_DECLARE_LOGGING_CATEGORY(KUBUNTU_L10N_LOCALE)
+Q_DECLARE_LOGGING_CATEGORY(KUBUNTU_L10N_PACKAGES)
+
+namespace Kubuntu {
+
+/**
+ * Logs the time spent in its scope to a category once it goes out of scope.
+ * Does nothing beyond a flag check unless debug output of the category is
+ * enabled or a Statistics counter is given, which always gets the time added.
+ */
+class ScopedTimer
+{
+public:
+    ScopedTimer(const QLoggingCategory &category, const char *what)
+        : m_category(category)
+        , m_what(what)
+        , m_counter(-1)
+    {
+        if (m_category.isDebugEnabled())
+            m_timer.start();
+    }
+
+    ScopedTimer(const QLoggingCategory &category, const char *what,
+                Statistics::Counter counter)
+        : m_category(category)
+        , m_what(what)
+        , m_counter(counter)
+    {
+        m_timer.start();
+    }
+
+    ~ScopedTimer()
+    {
+        if (!m_timer.isValid())
+            return;
+        const qint64 nsecs = m_timer.nsecsElapsed();
+        if (m_counter >= 0)
+            recordStatistics(static_cast<Statistics::Counter>(m_counter), 0, nsecs);
+        if (m_category.isDebugEnabled())
+            QMessageLogger().debug(m_category) << m_what << "took" << nsecs / 1000 << "us";
+    }
+
+private:
+    const QLoggingCategory &m_category;
+    const char *const m_what;
+    const int m_counter;
+    QElapsedTimer m_timer;
+
+    Q_DISABLE_COPY(ScopedTimer)
+};
+
+} // namespace Kubuntu
+
+#endif // L10N_DEBUG_P_H
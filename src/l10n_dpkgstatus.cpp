@@ -0,0 +1,439 @@
+/*
+  Copyright (C) 2015 Harald Sitter <sitter@kde.org>
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) version 3, or any
+  later version accepted by the membership of KDE e.V. (or its
+  successor approved by the membership of KDE e.V.), which shall
+  act as a proxy defined in Section 6 of version 3 of the license.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "l10n_dpkgstatus_p.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QMutex>
+#include <QMutexLocker>
+
+#include <string.h>
+
+#include "l10n_debug_p.h"
+#include "l10n_sharedcache_p.h"
+
+namespace Kubuntu {
+
+struct SystemDpkgStatus
+{
+    QMutex mutex;
+    QString path;
+    DpkgStatus::Ptr status;
+};
+
+Q_GLOBAL_STATIC(SystemDpkgStatus, s_systemStatus)
+
+// FNV-1a, package names are plain ASCII so hashing the QString and the raw
+// bytes from the status file yields the same value.
+static const quint32 s_fnvOffset = 2166136261u;
+static const quint32 s_fnvPrime = 16777619u;
+
+static quint32 hashBytes(const char *data, int length)
+{
+    quint32 hash = s_fnvOffset;
+    for (int i = 0; i < length; ++i) {
+        hash ^= static_cast<uchar>(data[i]);
+        hash *= s_fnvPrime;
+    }
+    return hash;
+}
+
+static bool hashString(const QString &string, quint32 *hash)
+{
+    *hash = s_fnvOffset;
+    const QChar *data = string.constData();
+    for (int i = 0; i < string.size(); ++i) {
+        const ushort c = data[i].unicode();
+        if (c > 0x7f) // Can not possibly be a package name.
+            return false;
+        *hash ^= c;
+        *hash *= s_fnvPrime;
+    }
+    return true;
+}
+
+// Returns the trimmed value of a "Field: value" line if the line is for field.
+static bool fieldValue(const char *line, int length,
+                       const char *field, int fieldLength,
+                       const char **value, int *valueLength)
+{
+    if (length < fieldLength || memcmp(line, field, fieldLength) != 0)
+        return false;
+    const char *begin = line + fieldLength;
+    const char *end = line + length;
+    while (begin < end && (*begin == ' ' || *begin == '\t'))
+        ++begin;
+    while (end > begin && (end[-1] == ' ' || end[-1] == '\t' || end[-1] == '\r'))
+        --end;
+    *value = begin;
+    *valueLength = end - begin;
+    return true;
+}
+
+DpkgStatus::DpkgStatus()
+    : m_valid(false)
+    , m_count(0)
+    , m_mask(0)
+    , m_entries(nullptr)
+    , m_capacity(0)
+{
+}
+
+DpkgStatus::Ptr DpkgStatus::system()
+{
+    SystemDpkgStatus *system = s_systemStatus();
+    QMutexLocker locker(&system->mutex);
+    const QString filePath = system->path.isEmpty() ? defaultPath() : system->path;
+    const QDateTime lastModified = QFileInfo(filePath).lastModified();
+    if (!system->status || system->status->lastModified() != lastModified)
+        system->status = SharedCache::isEnabled() ? fromSharedCache(filePath) : fromFile(filePath);
+    return system->status;
+}
+
+// Payload of the "dpkg-status" cache file, followed by the table and the
+// string pool.
+struct DpkgStatusCacheHeader
+{
+    quint32 count;
+    quint32 capacity;
+    quint32 stringsSize;
+    quint32 reserved;
+};
+
+DpkgStatus::Ptr DpkgStatus::fromSharedCache(const QString &filePath)
+{
+    const QString name = QLatin1String("dpkg-status");
+    const QByteArray key = SharedCache::sourceKey(QStringList() << filePath);
+    const QDateTime lastModified = QFileInfo(filePath).lastModified();
+
+    const SharedCache::FilePtr file = SharedCache::open(name, key);
+    if (file) {
+        QSharedPointer<DpkgStatus> status(new DpkgStatus);
+        if (status->loadSerialized(file)) {
+            status->m_lastModified = lastModified;
+            status->m_valid = true;
+            return status;
+        }
+        qCWarning(KUBUNTU_L10N_PACKAGES) << "inconsistent dpkg status cache";
+    }
+
+    const Ptr status = fromFile(filePath);
+    // The key describes the file before parsing, should it have changed in
+    // between the cache is merely stale for everyone.
+    if (status->isValid() && status->lastModified() == lastModified)
+        SharedCache::write(name, key, status->serialized());
+    return status;
+}
+
+QByteArray DpkgStatus::serialized() const
+{
+    DpkgStatusCacheHeader header;
+    header.count = m_count;
+    header.capacity = m_capacity;
+    header.stringsSize = m_strings.size();
+    header.reserved = 0;
+
+    QByteArray data;
+    data.reserve(sizeof(header) + m_capacity * sizeof(Entry) + m_strings.size());
+    data.append(reinterpret_cast<const char *>(&header), sizeof(header));
+    data.append(reinterpret_cast<const char *>(m_entries), m_capacity * sizeof(Entry));
+    data.append(m_strings);
+    return data;
+}
+
+bool DpkgStatus::loadSerialized(const SharedCache::FilePtr &file)
+{
+    Q_STATIC_ASSERT(sizeof(Entry) == 16);
+    Q_STATIC_ASSERT(sizeof(DpkgStatusCacheHeader) % 8 == 0);
+
+    if (file->size() < qint64(sizeof(DpkgStatusCacheHeader)))
+        return false;
+    DpkgStatusCacheHeader header;
+    memcpy(&header, file->data(), sizeof(header));
+
+    // Capacity must be a power of two with room to spare, see parse.
+    if (header.capacity < 16 || (header.capacity & (header.capacity - 1)) ||
+            header.count >= header.capacity)
+        return false;
+    const qint64 tableSize = qint64(header.capacity) * sizeof(Entry);
+    if (file->size() != qint64(sizeof(header)) + tableSize + header.stringsSize)
+        return false;
+
+    // Lookups trust the table, so make sure it can not lead out of bounds.
+    const Entry *entries = reinterpret_cast<const Entry *>(file->data() + sizeof(header));
+    quint32 count = 0;
+    for (quint32 i = 0; i < header.capacity; ++i) {
+        const Entry &entry = entries[i];
+        if (entry.nameLength == 0)
+            continue;
+        ++count;
+        if (quint64(entry.name) + entry.nameLength > header.stringsSize ||
+                quint64(entry.version) + entry.versionLength > header.stringsSize)
+            return false;
+    }
+    if (count != header.count)
+        return false;
+
+    m_cacheFile = file;
+    m_count = header.count;
+    m_capacity = header.capacity;
+    m_mask = header.capacity - 1;
+    m_entries = entries;
+    m_strings = QByteArray::fromRawData(reinterpret_cast<const char *>(entries) + tableSize,
+                                        header.stringsSize);
+    return true;
+}
+
+DpkgStatus::Ptr DpkgStatus::fromFile(const QString &filePath)
+{
+    ScopedTimer timer(KUBUNTU_L10N_PACKAGES(), "dpkg status parsing");
+    QSharedPointer<DpkgStatus> status(new DpkgStatus);
+
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly))
+        return status;
+
+    status->m_lastModified = QFileInfo(file).lastModified();
+
+    const qint64 size = file.size();
+    QByteArray buffer;
+    const char *data = size > 0 ? reinterpret_cast<const char *>(file.map(0, size)) : 0;
+    if (!data) { // Not mappable, e.g. empty or on an exotic file system.
+        buffer = file.readAll();
+        data = buffer.constData();
+    }
+    status->parse(data, buffer.isNull() ? size : buffer.size());
+    status->m_valid = true;
+
+    return status;
+}
+
+QString DpkgStatus::path()
+{
+    SystemDpkgStatus *system = s_systemStatus();
+    QMutexLocker locker(&system->mutex);
+    return system->path.isEmpty() ? defaultPath() : system->path;
+}
+
+void DpkgStatus::setPath(const QString &filePath)
+{
+    SystemDpkgStatus *system = s_systemStatus();
+    QMutexLocker locker(&system->mutex);
+    system->path = filePath;
+    system->status.clear();
+}
+
+QString DpkgStatus::defaultPath()
+{
+    return QLatin1String("/var/lib/dpkg/status");
+}
+
+bool DpkgStatus::isValid() const
+{
+    return m_valid;
+}
+
+int DpkgStatus::count() const
+{
+    return m_count;
+}
+
+QDateTime DpkgStatus::lastModified() const
+{
+    return m_lastModified;
+}
+
+bool DpkgStatus::isInstalled(const QString &packageName) const
+{
+    return find(packageName);
+}
+
+QString DpkgStatus::installedVersion(const QString &packageName) const
+{
+    const Entry *entry = find(packageName);
+    if (!entry)
+        return QString();
+    return QString::fromLatin1(m_strings.constData() + entry->version, entry->versionLength);
+}
+
+QSet<QString> DpkgStatus::changedPackages(const DpkgStatus &other) const
+{
+    QSet<QString> changed;
+    collectChanged(other, *this, &changed);
+    collectChanged(*this, other, &changed);
+    return changed;
+}
+
+void DpkgStatus::collectChanged(const DpkgStatus &from, const DpkgStatus &to,
+                                QSet<QString> *changed)
+{
+    for (quint32 i = 0; i < from.m_capacity; ++i) {
+        const Entry &entry = from.m_entries[i];
+        if (entry.nameLength == 0)
+            continue;
+        const char *name = from.m_strings.constData() + entry.name;
+        const Entry *match = to.find(name, entry.nameLength, entry.hash);
+        if (match && match->versionLength == entry.versionLength &&
+                memcmp(to.m_strings.constData() + match->version,
+                       from.m_strings.constData() + entry.version,
+                       entry.versionLength) == 0) {
+            continue;
+        }
+        changed->insert(QString::fromLatin1(name, entry.nameLength));
+    }
+}
+
+void DpkgStatus::parse(const char *data, qint64 size)
+{
+    struct Record {
+        const char *name;
+        int nameLength;
+        const char *version;
+        int versionLength;
+    };
+    QVector<Record> records;
+    records.reserve(4096);
+
+    Record record = { 0, 0, 0, 0 };
+    bool installed = false;
+
+    const char *end = data + size;
+    const char *line = data;
+    while (line <= end) {
+        const char *eol = static_cast<const char *>(memchr(line, '\n', end - line));
+        if (!eol)
+            eol = end;
+        const int length = eol - line;
+
+        const char *value = 0;
+        int valueLength = 0;
+        if (length == 0 || (length == 1 && *line == '\r')) {
+            // Stanza separator (or end of file).
+            if (installed && record.nameLength > 0)
+                records.append(record);
+            record.name = record.version = 0;
+            record.nameLength = record.versionLength = 0;
+            installed = false;
+        } else if (fieldValue(line, length, "Package:", 8, &value, &valueLength)) {
+            record.name = value;
+            record.nameLength = qMin(valueLength, 0xffff);
+        } else if (fieldValue(line, length, "Version:", 8, &value, &valueLength)) {
+            record.version = value;
+            record.versionLength = qMin(valueLength, 0xffff);
+        } else if (fieldValue(line, length, "Status:", 7, &value, &valueLength)) {
+            // Want: "install ok installed" or "hold ok installed". Anything
+            // else, particularly "half-installed" and "config-files", means the
+            // package is not usable.
+            static const char installedState[] = " installed";
+            const int stateLength = sizeof(installedState) - 1;
+            installed = valueLength >= stateLength &&
+                    memcmp(value + valueLength - stateLength, installedState, stateLength) == 0;
+        }
+
+        line = eol + 1;
+    }
+
+    quint32 capacity = 16;
+    while (capacity < quint32(records.size()) * 2)
+        capacity <<= 1;
+    m_mask = capacity - 1;
+
+    const Entry empty = { 0, 0, 0, 0, 0 };
+    m_table.fill(empty, capacity);
+    m_entries = m_table.constData();
+    m_capacity = capacity;
+
+    int poolSize = 0;
+    foreach (const Record &r, records)
+        poolSize += r.nameLength + r.versionLength;
+    m_strings.reserve(poolSize);
+
+    foreach (const Record &r, records) {
+        const quint32 hash = hashBytes(r.name, r.nameLength);
+        quint32 slot = hash & m_mask;
+        bool duplicate = false;
+        while (m_table.at(slot).nameLength != 0) {
+            const Entry &other = m_table.at(slot);
+            // Multi-arch packages can appear more than once; first one wins.
+            if (other.hash == hash && other.nameLength == r.nameLength &&
+                    memcmp(m_strings.constData() + other.name, r.name, r.nameLength) == 0) {
+                duplicate = true;
+                break;
+            }
+            slot = (slot + 1) & m_mask;
+        }
+        if (duplicate)
+            continue;
+
+        Entry &entry = m_table[slot];
+        entry.hash = hash;
+        entry.name = m_strings.size();
+        entry.nameLength = r.nameLength;
+        m_strings.append(r.name, r.nameLength);
+        entry.version = m_strings.size();
+        entry.versionLength = r.versionLength;
+        if (r.versionLength > 0)
+            m_strings.append(r.version, r.versionLength);
+        ++m_count;
+    }
+}
+
+const DpkgStatus::Entry *DpkgStatus::find(const QString &packageName) const
+{
+    if (m_count == 0 || packageName.isEmpty())
+        return 0;
+
+    quint32 hash;
+    if (!hashString(packageName, &hash))
+        return 0;
+
+    const int length = packageName.size();
+    const QChar *name = packageName.constData();
+    for (quint32 slot = hash & m_mask; m_entries[slot].nameLength != 0; slot = (slot + 1) & m_mask) {
+        const Entry &entry = m_entries[slot];
+        if (entry.hash != hash || entry.nameLength != length)
+            continue;
+        const char *candidate = m_strings.constData() + entry.name;
+        int i = 0;
+        while (i < length && name[i].unicode() == static_cast<uchar>(candidate[i]))
+            ++i;
+        if (i == length)
+            return &entry;
+    }
+    return 0;
+}
+
+const DpkgStatus::Entry *DpkgStatus::find(const char *name, int length, quint32 hash) const
+{
+    if (m_count == 0)
+        return 0;
+
+    for (quint32 slot = hash & m_mask; m_entries[slot].nameLength != 0; slot = (slot + 1) & m_mask) {
+        const Entry &entry = m_entries[slot];
+        if (entry.hash == hash && entry.nameLength == length &&
+                memcmp(m_strings.constData() + entry.name, name, length) == 0) {
+            return &entry;
+        }
+    }
+    return 0;
+}
+
+} // namespace Kubuntu
@@ -0,0 +1,133 @@
+/*
+  Copyright (C) 2015 Harald Sitter <sitter@kde.org>
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) version 3, or any
+  later version accepted by the membership of KDE e.V. (or its
+  successor approved by the membership of KDE e.V.), which shall
+  act as a proxy defined in Section 6 of version 3 of the license.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef L10N_DPKGSTATUS_P_H
+#define L10N_DPKGSTATUS_P_H
+
+#include "export.h"
+
+#include <QByteArray>
+#include <QDateTime>
+#include <QSet>
+#include <QSharedPointer>
+#include <QString>
+#include <QVector>
+
+#include "l10n_sharedcache_p.h"
+
+namespace Kubuntu {
+
+/**
+ * Read-only snapshot of the packages dpkg considers installed.
+ *
+ * The snapshot is parsed from a memory mapped dpkg status file into a compact
+ * open addressing hash table. Once constructed it never changes, so lookups
+ * may be done from any thread without locking and never require an APT cache.
+ *
+ * system() shares the table with other processes through the SharedCache
+ * when it is enabled, in which case the table is used straight from the
+ * mapped cache file.
+ */
+class KUBUNTU_TESTS_EXPORT DpkgStatus
+{
+public:
+    typedef QSharedPointer<const DpkgStatus> Ptr;
+
+    /**
+     * \returns the shared snapshot of the system status file. The file is only
+     * parsed again when its modification time changed since the last call.
+     */
+    static Ptr system();
+
+    /** \returns a new snapshot parsed from \p filePath */
+    static Ptr fromFile(const QString &filePath);
+
+    /** \returns the path system() reads, defaultPath() unless overridden */
+    static QString path();
+
+    /**
+     * Overrides the path system() reads, e.g. for fixtures or an alternative
+     * root. An empty path restores defaultPath().
+     */
+    static void setPath(const QString &filePath);
+
+    /** \returns the default path of the dpkg status file (/var/lib/dpkg/status) */
+    static QString defaultPath();
+
+    /** \returns \c false if the status file could not be read */
+    bool isValid() const;
+
+    /** \returns number of installed packages */
+    int count() const;
+
+    /** \returns modification time of the status file at the time of parsing */
+    QDateTime lastModified() const;
+
+    /** \returns \c true if a package by the name of \p packageName is installed */
+    bool isInstalled(const QString &packageName) const;
+
+    /** \returns the installed version of \p packageName or an empty string */
+    QString installedVersion(const QString &packageName) const;
+
+    /**
+     * \returns names of all packages that were installed, removed or changed
+     * version between \p other and this snapshot
+     */
+    QSet<QString> changedPackages(const DpkgStatus &other) const;
+
+private:
+    DpkgStatus();
+
+    struct Entry {
+        quint32 hash;
+        quint32 name; // Offset into m_strings.
+        quint32 version; // Offset into m_strings.
+        quint16 nameLength; // 0 marks an empty slot.
+        quint16 versionLength;
+    };
+
+    void parse(const char *data, qint64 size);
+    /** \returns the table in the SharedCache payload format */
+    QByteArray serialized() const;
+    /** \returns \c false if \p file does not hold a consistent table */
+    bool loadSerialized(const SharedCache::FilePtr &file);
+    static Ptr fromSharedCache(const QString &filePath);
+    const Entry *find(const QString &packageName) const;
+    const Entry *find(const char *name, int length, quint32 hash) const;
+    static void collectChanged(const DpkgStatus &from, const DpkgStatus &to,
+                               QSet<QString> *changed);
+
+    bool m_valid;
+    int m_count;
+    QDateTime m_lastModified;
+    quint32 m_mask;
+    // Point into m_table or the mapped cache file.
+    const Entry *m_entries;
+    quint32 m_capacity;
+    QVector<Entry> m_table;
+    QByteArray m_strings;
+    SharedCache::FilePtr m_cacheFile;
+
+    Q_DISABLE_COPY(DpkgStatus)
+};
+
+} // namespace Kubuntu
+
+#endif // L10N_DPKGSTATUS_P_H
@@ -0,0 +1,94 @@
+/*
+  Copyright (C) 2015 Harald Sitter <sitter@kde.org>
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) version 3, or any
+  later version accepted by the membership of KDE e.V. (or its
+  successor approved by the membership of KDE e.V.), which shall
+  act as a proxy defined in Section 6 of version 3 of the license.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "l10n_internal.h"
+
+#include "l10n_dpkgstatus_p.h"
+#include "l10n_memorypackageprovider_p.h"
+#include "l10n_pkgdepends_p.h"
+
+namespace Kubuntu {
+
+namespace Internal {
+
+QString dpkgStatusPath()
+{
+    return DpkgStatus::path();
+}
+
+void setDpkgStatusPath(const QString &filePath)
+{
+    DpkgStatus::setPath(filePath);
+}
+
+QString defaultDpkgStatusPath()
+{
+    return DpkgStatus::defaultPath();
+}
+
+QString pkgDependsPath()
+{
+    return PkgDepends::path();
+}
+
+void setPkgDependsPath(const QString &filePath)
+{
+    PkgDepends::setPath(filePath);
+}
+
+QString defaultPkgDependsPath()
+{
+    return PkgDepends::defaultPath();
+}
+
+bool isPkgDependsValid()
+{
+    return PkgDepends::system()->isValid();
+}
+
+FixturePackages::FixturePackages()
+    : d(new MemoryPackageProvider)
+{
+}
+
+FixturePackages::~FixturePackages()
+{
+    // Also resets the default provider if it is this one.
+    delete d;
+}
+
+bool FixturePackages::load(const QString &filePath)
+{
+    return d->load(filePath);
+}
+
+bool FixturePackages::loadControlFile(const QString &filePath)
+{
+    return d->loadControlFile(filePath);
+}
+
+void FixturePackages::install()
+{
+    PackageProvider::setDefaultProvider(d);
+}
+
+} // namespace Internal
+
+} // namespace Kubuntu
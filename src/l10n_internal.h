@@ -0,0 +1,111 @@
+/*
+  Copyright (C) 2015 Harald Sitter <sitter@kde.org>
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) version 3, or any
+  later version accepted by the membership of KDE e.V. (or its
+  successor approved by the membership of KDE e.V.), which shall
+  act as a proxy defined in Section 6 of version 3 of the license.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef KUBUNTU_L10N_INTERNAL_H
+#define KUBUNTU_L10N_INTERNAL_H
+
+#include "export.h"
+
+#include <QString>
+
+namespace Kubuntu {
+
+class MemoryPackageProvider;
+
+/**
+ * Hooks for Kubuntu's own tools, such as kubuntu-l10n-audit, to run support
+ * checks against another system or fixtures instead of the running system.
+ *
+ * Not covered by any API or ABI promise, applications must not use them.
+ */
+namespace Internal {
+
+/** \returns the dpkg status file read for installed states */
+KUBUNTU_EXPORT QString dpkgStatusPath();
+
+/**
+ * Overrides the dpkg status file, e.g. for an alternative root. An empty
+ * path restores defaultDpkgStatusPath().
+ */
+KUBUNTU_EXPORT void setDpkgStatusPath(const QString &filePath);
+
+/** \returns the default path of the dpkg status file (/var/lib/dpkg/status) */
+KUBUNTU_EXPORT QString defaultDpkgStatusPath();
+
+/** \returns the language-selector pkg_depends file read for rules */
+KUBUNTU_EXPORT QString pkgDependsPath();
+
+/**
+ * Overrides the pkg_depends file, e.g. for an alternative root. An empty
+ * path restores defaultPkgDependsPath().
+ */
+KUBUNTU_EXPORT void setPkgDependsPath(const QString &filePath);
+
+/** \returns the default path of the system pkg_depends file */
+KUBUNTU_EXPORT QString defaultPkgDependsPath();
+
+/** \returns \c false if the pkg_depends file can not be read */
+KUBUNTU_EXPORT bool isPkgDependsValid();
+
+/**
+ * Package states kept in memory instead of the APT cache. Installs always
+ * succeed and only mark the packages installed.
+ */
+class KUBUNTU_EXPORT FixturePackages
+{
+public:
+    FixturePackages();
+    /** Stops being used by Languages and collections created afterwards. */
+    ~FixturePackages();
+
+    /**
+     * Adds the packages listed in a fixture file. Every line holds a package
+     * name, optionally followed by \c installed. Empty lines and lines
+     * starting with # are ignored.
+     *
+     * \returns \c false if the file could not be read
+     */
+    bool load(const QString &filePath);
+
+    /**
+     * Adds the packages of a deb822 control file such as dpkg's status file
+     * or an APT Packages list.
+     *
+     * \returns \c false if the file could not be read
+     */
+    bool loadControlFile(const QString &filePath);
+
+    /**
+     * Makes all Languages and LanguageCollections created from now on use
+     * these packages instead of the APT cache.
+     */
+    void install();
+
+private:
+    Q_DISABLE_COPY(FixturePackages)
+
+    MemoryPackageProvider *const d;
+};
+
+} // namespace Internal
+
+} // namespace Kubuntu
+
+#endif // KUBUNTU_L10N_INTERNAL_H
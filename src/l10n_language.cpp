@@ -19,22 +19,26 @@
 */
 
 #include "l10n_language.h"
+#include "l10n_language_p.h"
 
 #include <KConfigGroup>
 #include <KLocalizedString>
-#include <KProtocolManager>
 #include <KSharedConfig>
 
-#include <QApt/Backend>
-#include <QApt/Transaction>
-
-#include <QDebug>
-#include <QFile>
-#include <QStringBuilder>
+#include <QHash>
+#include <QMetaObject>
+#include <QMutexLocker>
 #include <QStringList>
 
+#include <algorithm>
+
+#include "l10n_debug_p.h"
 #include "l10n_languagecollection.h"
 #include "l10n_languagecollection_p.h"
+#include "l10n_packageprovider_p.h"
+#include "l10n_pkgdepends_p.h"
+#include "l10n_qaptpackageprovider_p.h"
+#include "l10n_stringtable_p.h"
 
 namespace Kubuntu {
 
@@ -50,117 +54,90 @@ static const char *s_languageCodeMap[][3] = {
     { 0 }
 };
 
+// Lookups only allocate for the returned string of mapped codes, unmapped
+// codes are returned as shared copies of the input.
 QString Language::ubuntuPackageCodeForKdeCode(const QString &kdeCode)
 {
-    QString ubuntuPkg = kdeCode;
     for (int i = 0; s_languageCodeMap[i][0]; ++i) {
         if (kdeCode == QLatin1String(s_languageCodeMap[i][1])) {
-            QString kdePackageCode = QLatin1String(s_languageCodeMap[i][0]);
-            if (s_languageCodeMap[i][2] && (s_languageCodeMap[i][2] != kdePackageCode))
-                ubuntuPkg = QLatin1String(s_languageCodeMap[i][2]);
+            if (s_languageCodeMap[i][2] && qstrcmp(s_languageCodeMap[i][2], s_languageCodeMap[i][0]) != 0)
+                return QString::fromLatin1(s_languageCodeMap[i][2]);
             break;
         }
     }
-    return ubuntuPkg;
+    return kdeCode;
 }
 
 QString Language::kdeLanguageCodeForKdePackageCode(const QString &kdePkg)
 {
-    QString kdeCode = kdePkg;
     for (int i = 0; s_languageCodeMap[i][0]; ++i) {
-        if (kdePkg == QLatin1String(s_languageCodeMap[i][0])) {
-            kdeCode = QLatin1String(s_languageCodeMap[i][1]);
-            break;
-        }
+        if (kdePkg == QLatin1String(s_languageCodeMap[i][0]))
+            return QString::fromLatin1(s_languageCodeMap[i][1]);
     }
-    return kdeCode;
+    return kdePkg;
 }
 
 QString Language::kdePackageCodeForKdeLanguageCode(const QString &kdeCode)
 {
-    QString kdePkg = kdeCode;
     for (int i = 0; s_languageCodeMap[i][0]; ++i) {
-        if (kdeCode == QLatin1String(s_languageCodeMap[i][1])) {
-            kdePkg = QLatin1String(s_languageCodeMap[i][0]);
-            break;
-        }
+        if (kdeCode == QLatin1String(s_languageCodeMap[i][1]))
+            return QString::fromLatin1(s_languageCodeMap[i][0]);
     }
-    return kdePkg;
+    return kdeCode;
 }
 
-class LanguagePrivate
+struct LanguageRegistry
 {
-public:
-    LanguagePrivate(Language *q,
-                    const QString language = QString(),
-                    LanguageCollection *collection = 0);
-    ~LanguagePrivate();
-
-    /** Helper to clean up after a transaction ended. */
-    void transactionCleanup();
-
-    /** Slot handling QApt transaction errors. */
-    void transactionError();
-
-    /** Slot handling QApt transactions ending. */
-    void transactionFinished(QApt::ExitStatus exitStatus);
-
-    /**
-     * Checks if a package by the name of pkgName exists and if it is not
-     * installed and not already in the missingPackages set it will be added.
-     *
-     * \param pkgName the name of the package to possibly append
-     * \see possiblyAddMissingPrefixPackage
-     */
-    void possiblyAddMissingPackage(const QString &pkgName);
-
-    /**
-     * Checks if prefix + kdeLanguage and prefix + ubuntuLanguage are packages
-     * and whether they are installed. If they are packages and not installed
-     * they will be added to missingPackages.
-     *
-     * \param prefix package prefix, language values are appended to form a package name
-     * \see possiblyAddMissingPackage
-     */
-    void possiblyAddMissingPrefixPackage(const QString &prefix);
-
-    Language *const q_ptr;
-    Q_DECLARE_PUBLIC(Language)
-
-    QString kdeLanguage;
-    QString ubuntuLanguage;
-
-    LanguageCollection *collection;
-    QApt::Backend *backend;
-    QSet<QApt::Package *> missingPackages;
-    QApt::Transaction *transaction;
-
-private:
-    LanguagePrivate() : q_ptr(nullptr) { Q_ASSERT(q_ptr); }
-    Q_DISABLE_COPY(LanguagePrivate)
+    QMutex mutex;
+    // Weak so unused data goes away with its last Language. Expired entries
+    // are not pruned, there are only about a hundred language codes.
+    QHash<QString, QWeakPointer<const LanguageData> > languages;
 };
 
+Q_GLOBAL_STATIC(LanguageRegistry, s_languageRegistry)
+
+LanguageData::LanguageData(const QString &kdeLanguage)
+    : kdeLanguage(kdeLanguage)
+    , kdePackage(Language::kdePackageCodeForKdeLanguageCode(kdeLanguage))
+    , ubuntuLanguage(Language::ubuntuPackageCodeForKdeCode(kdeLanguage))
+    // Strip all random nonesense away.
+    , systemLanguage(kdeLanguage.split(QChar('@')).at(0).split(QChar('_')).at(0))
+    , kdePackageId(StringTable::intern(kdePackage))
+    , ubuntuLanguageId(StringTable::intern(ubuntuLanguage))
+{
+}
+
+QSharedPointer<const LanguageData> LanguageData::instance(const QString &kdeLanguage)
+{
+    LanguageRegistry *registry = s_languageRegistry();
+    QMutexLocker locker(&registry->mutex);
+    QSharedPointer<const LanguageData> data = registry->languages.value(kdeLanguage).toStrongRef();
+    if (!data) {
+        data = QSharedPointer<const LanguageData>(new LanguageData(kdeLanguage));
+        registry->languages.insert(kdeLanguage, data);
+    }
+    return data;
+}
+
 LanguagePrivate::LanguagePrivate(Language *q,
                                  const QString language,
                                  LanguageCollection *collection)
     : q_ptr(q)
-    , kdeLanguage(language)
-    , ubuntuLanguage(q->ubuntuPackageCodeForKdeCode(kdeLanguage))
     , collection(collection)
-    , backend()
+    , provider(nullptr)
+    , ownsProvider(false)
     , transaction(nullptr)
+    , m_missingPackageListValid(true)
 {
-    // Init backend.
-    if (!collection) {
-        backend = new QApt::Backend;
-        backend->init();
-    } else {
+    // Init provider. Without a collection this is deferred to ensureProvider().
+    if (collection) {
         // Collection is our parent, so it's no problem that we hold a ptr here.
-        backend = &collection->d_ptr->backend;
-        // Backend assumed to be initalized/updated by the user of the collection.
+        provider = collection->d_ptr->provider;
+        // Provider assumed to be initalized/updated by the user of the collection.
     }
 
     // Init languages.
+    QString kdeLanguage = language;
     if (kdeLanguage.isEmpty()) {
         KSharedConfigPtr config = KSharedConfig::openConfig("kdeglobals", KConfig::CascadeConfig);
         KConfigGroup settings = KConfigGroup(config, "Locale");
@@ -168,74 +145,214 @@ LanguagePrivate::LanguagePrivate(Language *q,
         kdeLanguage = settings.readEntry("Language", QString::fromLatin1("en_US"));
         if (kdeLanguage.contains(QChar(':')))
             kdeLanguage = kdeLanguage.split(QChar(':')).at(0);
+    }
+    data = LanguageData::instance(kdeLanguage);
+}
 
-        ubuntuLanguage = q->ubuntuPackageCodeForKdeCode(kdeLanguage);
+LanguagePrivate::~LanguagePrivate()
+{
+    if (ownsProvider)
+        delete provider;
+}
+
+QStringList LanguagePrivate::missingPackageList() const
+{
+    if (!m_missingPackageListValid) {
+        m_missingPackageList = missingPackages.toList();
+        m_missingPackageListValid = true;
     }
+    return m_missingPackageList;
+}
 
-//    qDebug() << kdeLanguage << ubuntuLanguage;
+void LanguagePrivate::insertMissingPackage(const QString &package)
+{
+    missingPackages.insert(package);
+    m_missingPackageListValid = false;
 }
 
-LanguagePrivate::~LanguagePrivate()
+void LanguagePrivate::clearMissingPackages()
 {
-    if (!collection) // Created our own backend.
-        delete backend;
+    missingPackages.clear();
+    m_missingPackageList.clear();
+    m_missingPackageListValid = true;
 }
 
-void LanguagePrivate::transactionCleanup()
+void LanguagePrivate::transactionFinished(bool success)
 {
+    Q_Q(Language);
     transaction = nullptr;
-    // Reload cache to reset pending changes, this way error'd installs will not
-    // keep repeating for any subsequent attempts.
-    backend->reloadCache();
+    const QList<QPointer<Language> > affected = transactionLanguages;
+    transactionLanguages.clear();
+
+    qCDebug(KUBUNTU_L10N_LANGUAGE) << Q_FUNC_INFO << data->kdeLanguage << success;
+
+    if (!success) {
+        emit q->supportCompletionFailed();
+        return;
+    }
+
+    // Everything got installed, the next check must not answer from the
+    // stale missing sets.
+    foreach (const QPointer<Language> &language, affected) {
+        if (!language)
+            continue;
+        LanguagePrivate *d = language->d_func();
+        QMutexLocker locker(&d->mutex);
+        d->clearMissingPackages();
+    }
+    emit q->supportComplete();
 }
 
-void LanguagePrivate::transactionError()
+PackageProvider *LanguagePrivate::ensureProvider()
 {
-    Q_Q(Language);
-    if (!transaction)
+    if (!provider) {
+        provider = PackageProvider::defaultProvider();
+        if (!provider) {
+            provider = new QAptPackageProvider;
+            ownsProvider = true;
+        }
+    }
+    return provider;
+}
+
+bool LanguagePrivate::isPackageInstalled(PackageProvider *provider, const QString &pkgName)
+{
+    return provider->isInstalled(pkgName);
+}
+
+bool LanguagePrivate::isPackageAvailable(PackageProvider *provider, const QString &pkgName)
+{
+    return provider->hasPackage(pkgName);
+}
+
+void LanguagePrivate::possiblyAddMissingPackage(PackageProvider *provider, const QString &pkgName)
+{
+    relevantPackages.insert(pkgName);
+    if (missingPackages.contains(pkgName) || isPackageInstalled(provider, pkgName))
         return;
 
-    transactionCleanup();
+    // Not installed, the cache needs to tell whether it is available at all.
+    if (isPackageAvailable(provider, pkgName))
+        insertMissingPackage(pkgName);
+}
 
-    qDebug() << Q_FUNC_INFO;
-    emit q->supportCompletionFailed();
+void LanguagePrivate::possiblyAddMissingPrefixPackage(PackageProvider *provider, quint32 prefixId)
+{
+    // Composed once per process, later evaluations share the names.
+    possiblyAddMissingPackage(provider, StringTable::packageName(prefixId, data->kdePackageId));
+    possiblyAddMissingPackage(provider, StringTable::packageName(prefixId, data->ubuntuLanguageId));
 }
 
-void LanguagePrivate::transactionFinished(QApt::ExitStatus exitStatus)
+void LanguagePrivate::evaluateSupport(const PkgDepends &pkgDepends)
 {
-    Q_Q(Language);
-    if (!transaction)
+    evaluateSupport(QList<LanguagePrivate *>() << this, pkgDepends);
+}
+
+void LanguagePrivate::evaluateSupport(const QList<LanguagePrivate *> &languages,
+                                      const PkgDepends &pkgDepends)
+{
+    if (languages.isEmpty())
         return;
 
-    transactionCleanup();
+    ScopedTimer timer(KUBUNTU_L10N_LANGUAGE(), "support evaluation");
+    PackageProvider *provider = languages.first()->ensureProvider();
 
-    qDebug() << Q_FUNC_INFO << exitStatus;
+    // Lists may contain the same Language more than once. Locked in address
+    // order so concurrent evaluations of overlapping sets can not deadlock.
+    QList<LanguagePrivate *> evaluators = languages.toSet().toList();
+    std::sort(evaluators.begin(), evaluators.end());
+    foreach (LanguagePrivate *language, evaluators)
+        language->mutex.lock();
 
-    switch (exitStatus) {
-    case QApt::ExitSuccess:
-        emit q->supportComplete();
-        break;
-    case QApt::ExitCancelled:
-    case QApt::ExitFailed:
-    case QApt::ExitPreviousFailed:
-    case QApt::ExitUnfinished:
-        emit q->supportCompletionFailed();
-        break;
+    provider->refresh();
+
+    foreach (const PkgDependsRule &rule, pkgDepends.rules()) {
+        // Whether the trigger is installed is the same for all languages,
+        // only ask once and only if any language needs to know.
+        int triggerInstalled = -1;
+
+        foreach (LanguagePrivate *language, evaluators) {
+            const LanguageData *data = language->data.data();
+
+            // Check if rule is for all langs or for this one specifically.
+            if (rule.languageId != StringTable::EmptyId && rule.languageId != data->ubuntuLanguageId)
+                continue;
+
+            //if it is always to be installed, go for it
+            if (rule.triggerId == StringTable::EmptyId) {
+                language->possiblyAddMissingPrefixPackage(provider, rule.packageId);
+                continue;
+            }
+
+            //if it is only if another package is installed check that
+            language->relevantPackages.insert(rule.trigger);
+            if (triggerInstalled < 0)
+                triggerInstalled = isPackageInstalled(provider, rule.trigger) ? 1 : 0;
+            if (!triggerInstalled)
+                continue;
+
+            // There are per-language packages such as kde-l10n-xx and meta ones such as chromium-l10n.
+            // Former needs concat whereas latter needs as-is usage
+            if (rule.isPrefix()) { // Per-language
+                language->possiblyAddMissingPrefixPackage(provider, rule.packageId);
+            } else { // Meta
+                language->possiblyAddMissingPackage(provider, rule.package);
+            }
+        }
+    }
+
+    foreach (LanguagePrivate *language, evaluators) {
+        language->mutex.unlock();
+        if (language->collection) // Reverse index of the collection is out of date now.
+            language->collection->d_ptr->supportIndexDirty.storeRelease(1);
     }
 }
 
-void LanguagePrivate::possiblyAddMissingPackage(const QString &pkgName)
+bool LanguagePrivate::completeSupport(const QStringList &packages,
+                                      const QList<Language *> &affected)
 {
-    QApt::Package *package = 0;
-    package = backend->package(pkgName);
-    if (package && !package->isInstalled() && !missingPackages.contains(package))
-        missingPackages.insert(package);
+    Q_Q(Language);
+    if (transaction)
+        return false;
+
+    transaction = ensureProvider()->commitInstall(packages);
+    if (!transaction) {
+        // Still async, so callers can connect after starting.
+        QMetaObject::invokeMethod(q, "supportCompletionFailed", Qt::QueuedConnection);
+        return true;
+    }
+
+    transactionLanguages.clear();
+    foreach (Language *language, affected)
+        transactionLanguages.append(QPointer<Language>(language));
+    QObject::connect(transaction, SIGNAL(progressChanged(int)),
+                     q, SIGNAL(supportCompletionProgress(int)));
+    QObject::connect(transaction, SIGNAL(finished(bool)),
+                     q, SLOT(transactionFinished(bool)));
+    transaction->run();
+    return true;
 }
 
-void LanguagePrivate::possiblyAddMissingPrefixPackage(const QString &prefix)
+void LanguagePrivate::reevaluateSupport(const PkgDepends &pkgDepends)
 {
-    possiblyAddMissingPackage(prefix % Language::kdePackageCodeForKdeLanguageCode(kdeLanguage));
-    possiblyAddMissingPackage(prefix % ubuntuLanguage);
+    Q_Q(Language);
+    QSet<QString> previouslyMissing;
+    {
+        QMutexLocker locker(&mutex);
+        previouslyMissing = missingPackages;
+        clearMissingPackages();
+        relevantPackages.clear();
+    }
+    evaluateSupport(pkgDepends);
+
+    bool complete;
+    {
+        QMutexLocker locker(&mutex);
+        if (missingPackages == previouslyMissing)
+            return;
+        complete = missingPackages.isEmpty();
+    }
+    emit q->supportStatusChanged(complete);
 }
 
 Language::Language()
@@ -246,6 +363,7 @@ Language::Language(const QString language, QObject *parent)
     : QObject(parent)
     , d_ptr(new LanguagePrivate(this, language, qobject_cast<LanguageCollection *>(parent)))
 {
+    recordStatistics(Statistics::LanguagesCreated);
 }
 
 Language::~Language()
@@ -255,125 +373,64 @@ Language::~Language()
 QString Language::kdeLanguageCode() const
 {
     Q_D(const Language);
-    return d->kdeLanguage;
+    return d->data->kdeLanguage;
 }
 
 QString Language::kdePackageCode() const
 {
     Q_D(const Language);
-    // This is not cached because this is the only use we have internally and
-    // the function ought not be called that often (mostly once on init and
-    // once if the package is being installed, though even latter is unlikely).
-    return kdePackageCodeForKdeLanguageCode(d->kdeLanguage);
+    return d->data->kdePackage;
 }
 
 QString Language::ubuntuPackageCode() const
 {
     Q_D(const Language);
-    return d->ubuntuLanguage;
+    return d->data->ubuntuLanguage;
 }
 
 QString Language::systemLanguageCode() const
 {
     Q_D(const Language);
-    QString code = d->kdeLanguage;
-    // Strip all random nonesense away.
-    code = code.split(QChar('@')).at(0).split(QChar('_')).at(0);
-    return code;
+    return d->data->systemLanguage;
 }
 
 bool Language::isSupportComplete()
 {
     Q_D(Language);
 
-    if (!d->missingPackages.isEmpty())
-        return false;
+    {
+        QMutexLocker locker(&d->mutex);
+        if (!d->missingPackages.isEmpty())
+            return false;
+    }
 
-    QFile file("/usr/share/language-selector/data/pkg_depends");
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+    const PkgDepends::Ptr pkgDepends = PkgDepends::system();
+    if (!pkgDepends->isValid()) {
         return true; // Must assume support is complete if we can't read the dep file :S
     }
 
-    // List of valid column identifiers
-    QStringList columns;
-    columns << QLatin1String("tr") << QLatin1String("wa")
-            << QLatin1String("fn") << QLatin1String("in");
-    while (!file.atEnd()) {
-        const QString line = file.readLine().simplified();
-        QStringList pkgDepends = line.split(':');
-
-        if (pkgDepends.isEmpty())
-            continue;
-
-        // Check it's a valid depends line.
-        if (!columns.contains(pkgDepends.at(0)))
-            continue;
+    d->evaluateSupport(*pkgDepends);
 
-        // Check if next value is for all langs or for this one specifically.
-        if (pkgDepends.at(1).isEmpty() || pkgDepends.at(1) == d->ubuntuLanguage) {
-            //if it is always to be installed, go for it
-            if (pkgDepends.at(2).isEmpty()) {
-                QString prefix = pkgDepends.at(3);
-
-                d->possiblyAddMissingPrefixPackage(prefix);
-            } else {
-                //if it is only if another package is installed check that
-                QApt::Package *dependency = d->backend->package(pkgDepends.at(2));
-                if (dependency && !dependency->installedVersion().isEmpty()) {
-                    QString prefix = pkgDepends.at(3);
-
-                    // There are per-language packages such as kde-l10n-xx and meta ones such as chromium-l10n.
-                    // Former needs concat whereas latter needs as-is usage
-                    if (prefix.right(1) == QChar('-')) { // Per-language
-                        d->possiblyAddMissingPrefixPackage(prefix);
-                    } else { // Meta
-                        d->possiblyAddMissingPackage(prefix);
-                    }
-                }
-            }
-        }
-    }
-    if (d->missingPackages.isEmpty())
-        return true;
-    return false;
+    QMutexLocker locker(&d->mutex);
+    return d->missingPackages.isEmpty();
 }
 
 QStringList Language::missingPackages() const
 {
     Q_D(const Language);
-    QStringList list;
-    foreach (QApt::Package *package, d->missingPackages) {
-        list.append(package->name());
-    }
-    return list;
+    QMutexLocker locker(&d->mutex);
+    return d->missingPackageList();
 }
 
 void Language::completeSupport()
 {
     Q_D(Language);
 
-    if (d->missingPackages.isEmpty())
+    const QStringList missingPackages = this->missingPackages();
+    if (missingPackages.isEmpty())
         return;
 
-    foreach (QApt::Package *p, d->missingPackages)
-        qDebug() << "installing" << p->name();
-    d->backend->markPackages(d->missingPackages.toList(), QApt::Package::ToInstall);
-    d->transaction = d->backend->commitChanges();
-
-    // Provide proxy/locale to the transaction
-    if (KProtocolManager::proxyType() == KProtocolManager::ManualProxy)
-        d->transaction->setProxy(KProtocolManager::proxyFor("http"));
-
-    d->transaction->setLocale(QLatin1String(setlocale(LC_MESSAGES, 0)));
-
-    connect(d->transaction, SIGNAL(progressChanged(int)),
-            this, SIGNAL(supportCompletionProgress(int)));
-    connect(d->transaction, SIGNAL(finished(QApt::ExitStatus)),
-            this, SLOT(transactionFinished(QApt::ExitStatus)));
-    connect(d->transaction, SIGNAL(errorOccurred(QApt::ErrorCode)),
-            this, SLOT(transactionError()));
-    qDebug() << "start";
-    d->transaction->run();
+    d->completeSupport(missingPackages, QList<Language *>() << this);
 }
 
 } // namespace Kubuntu
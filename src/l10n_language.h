@@ -29,6 +29,7 @@
 
 namespace Kubuntu {
 
+class LanguageCollectionPrivate;
 class LanguagePrivate;
 
 /**
@@ -39,16 +40,22 @@ class LanguagePrivate;
  *
  * Whenever possible Languages should be obtained from a LanguageCollection
  * rather than getting manually constructed.
+ *
+ * All Languages of the same KDE language code share their package codes
+ * process-wide. The support state depends on the package provider and is
+ * evaluated by every Language on its own.
  */
 class KUBUNTU_EXPORT Language : public QObject
 {
     Q_OBJECT
+    friend class LanguageCollectionPrivate;
+    friend class LocalePrivate;
 public:
     /** Constructs an instance with a language set.
      *
      * \param language the KDE language code to use
      * \param parent parent of the object, can be a LanguageCollection in which
-     *        case the internal QApt backend will be shared with the collection.
+     *        case the package provider will be shared with the collection.
      */
     explicit Language(const QString kdeLanguageCode, QObject *parent = 0);
 
@@ -102,14 +109,23 @@ signals:
      */
     void supportCompletionProgress(int progress);
 
+    /**
+     * Emitted when the set of missing packages changed because packages were
+     * installed or removed. Only emitted by Languages of a LanguageCollection
+     * watching the support status.
+     *
+     * \param complete \c true if support is complete now
+     * \see LanguageCollection::setSupportStatusWatched
+     */
+    void supportStatusChanged(bool complete);
+
 private:
     // Prevent construction of definitely invalid Language instances.
     Language();
 
     const QScopedPointer<LanguagePrivate> d_ptr;
     Q_DECLARE_PRIVATE(Language)
-    Q_PRIVATE_SLOT(d_func(),void transactionFinished(QApt::ExitStatus))
-    Q_PRIVATE_SLOT(d_func(),void transactionError())
+    Q_PRIVATE_SLOT(d_func(),void transactionFinished(bool))
 };
 
 } // namespace Kubuntu
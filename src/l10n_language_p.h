@@ -0,0 +1,181 @@
+/*
+  Copyright (C) 2014 Harald Sitter <apachelogger@kubuntu.org>
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) version 3, or any
+  later version accepted by the membership of KDE e.V. (or its
+  successor approved by the membership of KDE e.V.), which shall
+  act as a proxy defined in Section 6 of version 3 of the license.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef L10N_LANGUAGE_P_H
+#define L10N_LANGUAGE_P_H
+
+#include <QList>
+#include <QMutex>
+#include <QPointer>
+#include <QSet>
+#include <QSharedPointer>
+#include <QString>
+#include <QStringList>
+
+namespace Kubuntu {
+
+class Language;
+class LanguageCollection;
+class PackageProvider;
+class PackageTransaction;
+class PkgDepends;
+
+/**
+ * Code mappings shared by all Language instances of the same KDE language code.
+ *
+ * Obtained through instance(), which keeps a process-wide registry so that
+ * duplicate Languages do not compute the mappings again. Support states
+ * depend on the package provider and live in LanguagePrivate instead.
+ */
+class LanguageData
+{
+public:
+    /** \returns the shared data for \p kdeLanguage, created if necessary */
+    static QSharedPointer<const LanguageData> instance(const QString &kdeLanguage);
+
+    const QString kdeLanguage;
+    const QString kdePackage;
+    const QString ubuntuLanguage;
+    const QString systemLanguage;
+
+    /** StringTable ids of kdePackage and ubuntuLanguage */
+    const quint32 kdePackageId;
+    const quint32 ubuntuLanguageId;
+
+private:
+    explicit LanguageData(const QString &kdeLanguage);
+    Q_DISABLE_COPY(LanguageData)
+};
+
+class LanguagePrivate
+{
+public:
+    LanguagePrivate(Language *q,
+                    const QString language = QString(),
+                    LanguageCollection *collection = 0);
+    ~LanguagePrivate();
+
+    /** Slot handling install transactions ending. */
+    void transactionFinished(bool success);
+
+    /**
+     * Checks if a package by the name of pkgName exists and if it is not
+     * installed and not already in the missingPackages set it will be added.
+     *
+     * \param provider the provider to look the package up in
+     * \param pkgName the name of the package to possibly append
+     * \see possiblyAddMissingPrefixPackage
+     */
+    void possiblyAddMissingPackage(PackageProvider *provider, const QString &pkgName);
+
+    /**
+     * Checks if prefix + kdePackage and prefix + ubuntuLanguage are packages
+     * and whether they are installed. If they are packages and not installed
+     * they will be added to missingPackages.
+     *
+     * \param provider the provider to look the packages up in
+     * \param prefixId StringTable id of the package prefix, language values
+     *        are appended to form a package name
+     * \see possiblyAddMissingPackage
+     */
+    void possiblyAddMissingPrefixPackage(PackageProvider *provider, quint32 prefixId);
+
+    /** \returns \c true if pkgName is installed according to provider. */
+    static bool isPackageInstalled(PackageProvider *provider, const QString &pkgName);
+
+    /**
+     * \returns \c true if pkgName is a package known to provider. Only
+     * meaningful for packages that are not installed.
+     */
+    static bool isPackageAvailable(PackageProvider *provider, const QString &pkgName);
+
+    /**
+     * Adds all packages required by the pkgDepends rules to missingPackages.
+     * This only touches state of this Language, which is locked for the
+     * duration of the evaluation.
+     */
+    void evaluateSupport(const PkgDepends &pkgDepends);
+
+    /**
+     * Evaluates several Languages in a single pass over the rules, checking
+     * each trigger only once. All Languages are evaluated against the
+     * provider of the first one, which is only used for the duration of the
+     * call. \see evaluateSupport
+     */
+    static void evaluateSupport(const QList<LanguagePrivate *> &languages,
+                                const PkgDepends &pkgDepends);
+
+    /**
+     * Starts installing packages, on success the missing packages of all
+     * affected Languages are reset. Failure to start is reported asynchronously.
+     * \returns \c false if a transaction is already running
+     */
+    bool completeSupport(const QStringList &packages, const QList<Language *> &affected);
+
+    /**
+     * Drops the current evaluation and runs evaluateSupport again.
+     * Emits supportStatusChanged if the set of missing packages changed.
+     */
+    void reevaluateSupport(const PkgDepends &pkgDepends);
+
+    /**
+     * \returns the package provider. A Language without a collection uses
+     * PackageProvider::defaultProvider() or creates its own QApt provider on
+     * first use as most users never need one.
+     */
+    PackageProvider *ensureProvider();
+
+    Language *const q_ptr;
+    Q_DECLARE_PUBLIC(Language)
+
+    QSharedPointer<const LanguageData> data;
+
+    LanguageCollection *collection;
+    PackageProvider *provider;
+    /** Whether provider was created by ensureProvider and needs deleting. */
+    bool ownsProvider;
+    PackageTransaction *transaction;
+    /** Languages whose missing packages the running transaction installs. */
+    QList<QPointer<Language> > transactionLanguages;
+
+    /** Guards the support state as Languages may be evaluated concurrently. */
+    mutable QMutex mutex;
+    QSet<QString> missingPackages;
+    /**
+     * missingPackages as list, only rebuilt after changes. Modify the set
+     * through insertMissingPackage and clearMissingPackages only.
+     */
+    QStringList missingPackageList() const;
+    void insertMissingPackage(const QString &package);
+    void clearMissingPackages();
+    /** All packages the last evaluation depended on, either as trigger or as candidate. */
+    QSet<QString> relevantPackages;
+
+private:
+    LanguagePrivate() : q_ptr(nullptr) { Q_ASSERT(q_ptr); }
+    Q_DISABLE_COPY(LanguagePrivate)
+
+    mutable QStringList m_missingPackageList;
+    mutable bool m_missingPackageListValid;
+};
+
+} // namespace Kubuntu
+
+#endif // L10N_LANGUAGE_P_H
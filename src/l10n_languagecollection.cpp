@@ -21,55 +21,245 @@
 #include "l10n_languagecollection.h"
 #include "l10n_languagecollection_p.h"
 
+#include <QFileSystemWatcher>
+#include <QMetaObject>
 #include <QSet>
+#include <QStringList>
+#include <QtConcurrentMap>
 
+#include "l10n_debug_p.h"
 #include "l10n_language.h"
+#include "l10n_language_p.h"
+#include "l10n_packageprovider_p.h"
+#include "l10n_qaptpackageprovider_p.h"
 
 namespace Kubuntu {
 
-LanguageCollectionPrivate::LanguageCollectionPrivate()
-    : initalized(false)
+// Runs on the thread pool.
+static bool checkLanguageSupport(Language *language)
 {
+    return language->isSupportComplete();
+}
+
+LanguageCollectionPrivate::LanguageCollectionPrivate(LanguageCollection *q)
+    : q_ptr(q)
+    , provider(nullptr)
+    , initalized(false)
+    , languageInfosGeneration(0)
+    , languageInfosValid(false)
+    , supportCheckRunning(false)
+    , statusWatcher(nullptr)
+{
+    // dpkg rewrites the status file many times during a single apt run, wait
+    // for it to settle but still react well within a second.
+    statusTimer.setSingleShot(true);
+    statusTimer.setInterval(250);
+}
+
+void LanguageCollectionPrivate::supportCheckResultReady(int index)
+{
+    Q_Q(LanguageCollection);
+    Language *language = checkedLanguages.at(index);
+    const bool complete = supportWatcher.resultAt(index);
+    if (!complete)
+        incompleteLanguages.insert(language);
+    emit q->languageSupportChecked(language, complete);
+}
+
+void LanguageCollectionPrivate::supportCheckFinished()
+{
+    Q_Q(LanguageCollection);
+    checkedLanguages.clear();
+    if (!pendingLanguages.isEmpty()) { // Merged into this check meanwhile.
+        startSupportCheck();
+        return;
+    }
+
+    const QSet<Language *> incomplete = incompleteLanguages;
+    incompleteLanguages.clear();
+    supportCheckRunning = false;
+    emit q->supportChecked(incomplete);
+}
+
+void LanguageCollectionPrivate::startSupportCheck()
+{
+    checkedLanguages = pendingLanguages.toList();
+    pendingLanguages.clear();
+    supportCheckRunning = true;
+    supportWatcher.setFuture(QtConcurrent::mapped(checkedLanguages, checkLanguageSupport));
+}
+
+void LanguageCollectionPrivate::statusFileChanged()
+{
+    // dpkg replaces the file rather than writing to it, which drops the watch.
+    if (statusWatcher) {
+        const QStringList files = statusWatcher->files();
+        foreach (const QString &path, QStringList() << DpkgStatus::path() << PkgDepends::path()) {
+            if (!files.contains(path))
+                statusWatcher->addPath(path);
+        }
+    }
+    statusTimer.start();
+}
+
+void LanguageCollectionPrivate::updateSupportStatus()
+{
+    if (supportCheckRunning) { // Languages are busy, try again later.
+        statusTimer.start();
+        return;
+    }
+
+    const DpkgStatus::Ptr status = DpkgStatus::system();
+    const PkgDepends::Ptr pkgDepends = PkgDepends::system();
+    if (status == watchedStatus && pkgDepends == watchedPkgDepends)
+        return;
+
+    if (supportIndexDirty.testAndSetOrdered(1, 0))
+        rebuildSupportIndex();
+
+    QSet<Language *> affectedLanguages;
+    if (pkgDepends != watchedPkgDepends || !watchedStatus) {
+        // Rules changed, everything may be affected.
+        foreach (const QList<QPointer<Language> > &languages, supportIndex) {
+            foreach (const QPointer<Language> &language, languages) {
+                if (language)
+                    affectedLanguages.insert(language);
+            }
+        }
+    } else {
+        foreach (const QString &package, status->changedPackages(*watchedStatus)) {
+            foreach (const QPointer<Language> &language, supportIndex.value(package)) {
+                if (language)
+                    affectedLanguages.insert(language);
+            }
+        }
+    }
+
+    watchedStatus = status;
+    watchedPkgDepends = pkgDepends;
+
+    qCDebug(KUBUNTU_L10N_COLLECTION) << "support status affected for" << affectedLanguages.size() << "languages";
+    if (affectedLanguages.isEmpty() || !pkgDepends->isValid())
+        return;
+
+    ScopedTimer timer(KUBUNTU_L10N_COLLECTION(), "support status update");
+
+    // Pick up the status snapshot the change was detected in. The APT cache
+    // itself only needs reloading after our own transactions, which do that.
+    provider->refresh();
+
+    foreach (Language *language, affectedLanguages)
+        language->d_func()->reevaluateSupport(*pkgDepends);
+}
+
+void LanguageCollectionPrivate::rebuildSupportIndex()
+{
+    Q_Q(LanguageCollection);
+    supportIndex.clear();
+    foreach (Language *language, q->findChildren<Language *>(QString(), Qt::FindDirectChildrenOnly)) {
+        LanguagePrivate *d = language->d_func();
+        QMutexLocker locker(&d->mutex);
+        foreach (const QString &package, d->relevantPackages)
+            supportIndex[package].append(QPointer<Language>(language));
+    }
+}
+
+const QList<LanguageInfo> &LanguageCollectionPrivate::allLanguageInfos()
+{
+    // Installed states may have changed since the last query.
+    provider->refresh();
+    const int generation = provider->generation();
+    if (languageInfosValid && generation == languageInfosGeneration)
+        return languageInfos;
+
+    ScopedTimer timer(KUBUNTU_L10N_COLLECTION(), "language enumeration");
+    const QString queryString = QLatin1String("kde-l10n-");
+    const int queryStringLength = queryString.size();
+    const QString enUs = QLatin1String("en_US");
+    bool hasEnUs = false;
+
+    languageInfos.clear();
+    foreach (const QString &packageName, provider->packagesWithPrefix(queryString)) {
+        // It is more convenient to translate to code here rather than inside
+        // the Language ctor, as we like to utilize init lists in there.
+        // Also there ought not be a use case to construct a Language
+        // from a Package outside the collection.
+        const QString packageCode = packageName.mid(queryStringLength);
+        const QString languageCode = Language::kdeLanguageCodeForKdePackageCode(packageCode);
+        hasEnUs = hasEnUs || languageCode == enUs;
+        languageInfos.append(LanguageInfo(languageCode, packageCode, provider->isInstalled(packageName)));
+    }
+
+    // Manually inject en_US. This language does not actually exist, but is
+    // referenced on multiple occasions. We need to explicitly handle en_US
+    // because Ubuntu has a lot of stuff in language packs per language, such
+    // that documentation for gimp could for example be in gimp-help-en. Unless
+    // we allow en_US systems to check for completeness WRT this, they will have
+    // incomplete localization.
+    if (!hasEnUs)
+        languageInfos.append(LanguageInfo(enUs, Language::kdePackageCodeForKdeLanguageCode(enUs), true));
+
+    languageInfosGeneration = generation;
+    languageInfosValid = true;
+    return languageInfos;
 }
 
 LanguageCollection::LanguageCollection(QObject *parent)
     : QObject(parent)
-    , d_ptr(new LanguageCollectionPrivate)
+    , d_ptr(new LanguageCollectionPrivate(this))
 {
     Q_D(LanguageCollection);
-    d->initalized = d->backend.init();
-    connect(&d->backend, SIGNAL(xapianUpdateProgress(int)),
+    d->provider = PackageProvider::defaultProvider();
+    if (!d->provider) // Owned through the parent.
+        d->provider = new QAptPackageProvider(this);
+    d->initalized = d->provider->init();
+    connect(d->provider, SIGNAL(indexUpdateProgress(int)),
             this, SIGNAL(updateProgress(int)));
-    connect(&d->backend, SIGNAL(xapianUpdateFinished()),
+    connect(d->provider, SIGNAL(indexUpdated()),
             this, SIGNAL(updated()));
+    connect(&d->supportWatcher, SIGNAL(resultReadyAt(int)),
+            this, SLOT(supportCheckResultReady(int)));
+    connect(&d->supportWatcher, SIGNAL(finished()),
+            this, SLOT(supportCheckFinished()));
+    connect(&d->statusTimer, SIGNAL(timeout()),
+            this, SLOT(updateSupportStatus()));
 }
 
 LanguageCollection::~LanguageCollection()
 {
+    Q_D(LanguageCollection);
+    // Languages are our children and get deleted once we return, workers
+    // must not touch them anymore by then.
+    d->supportWatcher.cancel();
+    d->supportWatcher.waitForFinished();
+}
+
+bool LanguageCollection::isValid() const
+{
+    Q_D(const LanguageCollection);
+    return d->initalized;
 }
 
 bool LanguageCollection::isUpdated()
 {
     Q_D(LanguageCollection);
-    if (d->backend.openXapianIndex() && d->backend.xapianIndexNeedsUpdate())
-        return false;
-    return true;
+    return d->provider->isIndexUpdated();
 }
 
 void LanguageCollection::update()
 {
     Q_D(LanguageCollection);
-    if (isUpdated())
-        d->backend.updateXapianIndex();
-    else
-        emit updated();
+    if (!isUpdated())
+        d->provider->updateIndex();
+    else // Still async, so callers can connect after starting.
+        QMetaObject::invokeMethod(this, "updated", Qt::QueuedConnection);
 }
 
 QSet<Language *> LanguageCollection::languages()
 {
     Q_D(LanguageCollection);
 
-    // Prevent access to an uninitalized backend as QApt doesn't really like it
+    // Prevent access to an uninitalized provider as QApt doesn't really like it
     // and tends to explode at one point or another.
     // Init can only fail when either the config parsing/loading did not
     // work or when the cache cannot be opened for reading. Both are rather
@@ -79,38 +269,106 @@ QSet<Language *> LanguageCollection::languages()
         return QSet<Language *>();
     }
 
-    // Make sure the xapian cache is open at this point.
-    // TODO: look into the necessity of calling reloadCache here.
-    d->backend.openXapianIndex();
+    QSet<Language *> languages;
+    foreach (const LanguageInfo &info, d->allLanguageInfos())
+        languages.insert(language(info.kdeLanguageCode()));
 
-    const QString queryString = QLatin1String("kde-l10n-");
-    const int queryStringLength = queryString.size();
+    return languages;
+}
 
-    QSet<Language *> languages;
-    foreach (const QApt::Package *package, d->backend.search(queryString)) {
-        const QString packageName = QString(package->name());
-        if (packageName.startsWith(QLatin1String("kde-l10n-"))) {
-            QString languageCode = packageName.mid(queryStringLength);
-
-            // It is more convenient to translate to code here rather than inside
-            // the Language ctor, as we like to utilize init lists in there.
-            // Also there ought not be a use case to construct a Language
-            // from a Package outside the collection.
-            Language *language = new Language(Language::kdeLanguageCodeForKdePackageCode(languageCode), this);
-            languages.insert(language);
-        }
+Language *LanguageCollection::language(const QString &kdeLanguageCode)
+{
+    Q_D(LanguageCollection);
+    QPointer<Language> &language = d->languageInstances[kdeLanguageCode];
+    if (!language)
+        language = new Language(kdeLanguageCode, this);
+    return language;
+}
+
+QList<LanguageInfo> LanguageCollection::languageInfos(const QString &codePrefix,
+                                                      LanguageInfoFilters filters)
+{
+    Q_D(LanguageCollection);
+    if (!d->initalized) // See languages().
+        return QList<LanguageInfo>();
+
+    const QList<LanguageInfo> &allInfos = d->allLanguageInfos();
+    if (codePrefix.isEmpty() && !(filters & InstalledLanguages))
+        return allInfos;
+
+    QList<LanguageInfo> infos;
+    foreach (const LanguageInfo &info, allInfos) {
+        if (!info.kdeLanguageCode().startsWith(codePrefix))
+            continue;
+        if ((filters & InstalledLanguages) && !info.isInstalled())
+            continue;
+        infos.append(info);
     }
 
-    // Manually inject en_US. This language does not actually exist, but is
-    // referenced on multiple occasions. We need to explicitly handle en_US
-    // because Ubuntu has a lot of stuff in language packs per language, such
-    // that documentation for gimp could for example be in gimp-help-en. Unless
-    // we allow en_US systems to check for completeness WRT this, they will have
-    // incomplete localization.
-    Language *languageEnUs = new Language("en_US", this);
-    languages.insert(languageEnUs);
+    return infos;
+}
 
-    return languages;
+LanguageInfo LanguageCollection::languageInfo(const QString &kdeLanguageCode)
+{
+    Q_D(LanguageCollection);
+    if (!d->initalized || kdeLanguageCode.isEmpty())
+        return LanguageInfo();
+
+    const QString packageCode = Language::kdePackageCodeForKdeLanguageCode(kdeLanguageCode);
+    const QString packageName = QLatin1String("kde-l10n-") + packageCode;
+    if (d->provider->hasPackage(packageName))
+        return LanguageInfo(kdeLanguageCode, packageCode, d->provider->isInstalled(packageName));
+    if (kdeLanguageCode == QLatin1String("en_US"))
+        return LanguageInfo(kdeLanguageCode, packageCode, true);
+    return LanguageInfo();
+}
+
+void LanguageCollection::checkSupport(const QSet<Language *> &languages)
+{
+    Q_D(LanguageCollection);
+    foreach (Language *language, languages) {
+        // Languages being checked right now are reported by that check.
+        if (language->parent() == this && !d->checkedLanguages.contains(language))
+            d->pendingLanguages.insert(language);
+    }
+
+    // The watcher may not be running anymore while its finished signal is
+    // still queued, setting a new future would drop it.
+    if (!d->supportCheckRunning)
+        d->startSupportCheck();
+}
+
+void LanguageCollection::setSupportStatusWatched(bool watched)
+{
+    Q_D(LanguageCollection);
+    if (watched == isSupportStatusWatched())
+        return;
+
+    if (!watched) {
+        delete d->statusWatcher;
+        d->statusWatcher = nullptr;
+        d->statusTimer.stop();
+        d->watchedStatus.clear();
+        d->watchedPkgDepends.clear();
+        return;
+    }
+
+    // Current state is the baseline, anything evaluated before was based on it.
+    d->watchedStatus = DpkgStatus::system();
+    d->watchedPkgDepends = PkgDepends::system();
+    d->statusWatcher = new QFileSystemWatcher(this);
+    d->statusWatcher->addPath(DpkgStatus::path());
+    d->statusWatcher->addPath(PkgDepends::path());
+    connect(d->statusWatcher, SIGNAL(fileChanged(QString)),
+            this, SLOT(statusFileChanged()));
+}
+
+bool LanguageCollection::isSupportStatusWatched() const
+{
+    Q_D(const LanguageCollection);
+    return d->statusWatcher != nullptr;
 }
 
 } // namespace Kubuntu
+
+#include "moc_l10n_languagecollection.cpp"
@@ -23,7 +23,11 @@
 
 #include "export.h"
 
+#include <QList>
 #include <QObject>
+#include <QSet>
+
+#include "l10n_languageinfo.h"
 
 namespace Kubuntu {
 
@@ -48,6 +52,15 @@ class KUBUNTU_EXPORT LanguageCollection : public QObject
     Q_OBJECT
     friend class LanguagePrivate;
 public:
+    /** Restrictions of languageInfos */
+    enum LanguageInfoFilter {
+        /** All languages with packages */
+        AllLanguages = 0x0,
+        /** Only languages with installed KDE translations */
+        InstalledLanguages = 0x1
+    };
+    Q_DECLARE_FLAGS(LanguageInfoFilters, LanguageInfoFilter)
+
     /**
      * \brief Creates new collection.
      *
@@ -62,6 +75,13 @@ public:
     /** EXTERMINATE */
     ~LanguageCollection();
 
+    /**
+     * \returns \c false if the package backend could not be initialized
+     *
+     * An invalid collection is defunct and does not list any languages.
+     */
+    bool isValid() const;
+
     /** \returns \c true if the collection cache is up-to-date. */
     bool isUpdated();
 
@@ -73,9 +93,77 @@ public:
      */
     void update();
 
-    /** \returns a set of available languages (based on available packages) */
+    /**
+     * \returns a set of available languages (based on available packages)
+     *
+     * Languages are created once per KDE language code, repeated calls
+     * return the same instances. \see language
+     */
     QSet<Language *> languages();
 
+    /**
+     * \returns the collection's Language for \p kdeLanguageCode
+     *
+     * Every code is only ever represented by one Language of the collection,
+     * which is created on first use. Prefer this over constructing Languages
+     * directly.
+     *
+     * \param kdeLanguageCode the KDE language code (e.g. ca@valencia)
+     */
+    Language *language(const QString &kdeLanguageCode);
+
+    /**
+     * \returns descriptions of the available languages matching the filters
+     *
+     * Unlike languages() no Language objects are created, which makes this
+     * the preferred way to list languages, e.g. to populate a picker.
+     * The list is built once and shared by later calls until package states
+     * change.
+     *
+     * \param codePrefix only include KDE language codes starting with this
+     * \param filters further restrictions
+     */
+    QList<LanguageInfo> languageInfos(const QString &codePrefix = QString(),
+                                      LanguageInfoFilters filters = AllLanguages);
+
+    /**
+     * \returns the description of the language for \p kdeLanguageCode, an
+     * invalid LanguageInfo if no such language is available
+     */
+    LanguageInfo languageInfo(const QString &kdeLanguageCode);
+
+    /**
+     * Checks the support status of all \p languages in parallel on the global
+     * QThreadPool. This function is async.
+     *
+     * Only Languages of this collection are checked. Until supportChecked was
+     * emitted the Languages must not be used and the collection must not be
+     * updated. Calls while a check is running add their Languages to that
+     * check, supportChecked is then emitted once all of them were checked.
+     *
+     * \param languages set of Languages obtained from languages()
+     * \see languageSupportChecked \see supportChecked
+     */
+    void checkSupport(const QSet<Language *> &languages);
+
+    /**
+     * Enables or disables watching of the dpkg status for package changes.
+     *
+     * When enabled, every Language of this collection whose support status
+     * was determined gets re-evaluated as soon as one of the packages it
+     * depends on is installed, removed or upgraded outside the library.
+     * Languages with a changed set of missing packages emit
+     * Language::supportStatusChanged.
+     *
+     * Watching is off by default.
+     *
+     * \param watched whether to watch the support status
+     */
+    void setSupportStatusWatched(bool watched);
+
+    /** \returns \c true if the support status is watched \see setSupportStatusWatched */
+    bool isSupportStatusWatched() const;
+
 signals:
     /** Emitted when the cache update progress changes \see update */
     void updateProgress(int progress);
@@ -83,11 +171,35 @@ signals:
     /** Emitted when the cache update is finished \see update */
     void updated();
 
+    /**
+     * Emitted for every Language as soon as its support status is known.
+     *
+     * \param language the checked Language
+     * \param complete result of Language::isSupportComplete()
+     * \see checkSupport
+     */
+    void languageSupportChecked(Kubuntu::Language *language, bool complete);
+
+    /**
+     * Emitted once all Languages passed to checkSupport were checked. Calls
+     * merged into a running check share its emission.
+     *
+     * \param incompleteLanguages all Languages with missing packages
+     * \see checkSupport
+     */
+    void supportChecked(const QSet<Kubuntu::Language *> &incompleteLanguages);
+
 private:
     const QScopedPointer<LanguageCollectionPrivate> d_ptr;
     Q_DECLARE_PRIVATE(LanguageCollection)
+    Q_PRIVATE_SLOT(d_func(), void supportCheckResultReady(int))
+    Q_PRIVATE_SLOT(d_func(), void supportCheckFinished())
+    Q_PRIVATE_SLOT(d_func(), void statusFileChanged())
+    Q_PRIVATE_SLOT(d_func(), void updateSupportStatus())
 };
 
 } // namespace Kubuntu
 
+Q_DECLARE_OPERATORS_FOR_FLAGS(Kubuntu::LanguageCollection::LanguageInfoFilters)
+
 #endif // KUBUNTU_L10N_LANGUAGECOLLECTION_H
@@ -21,18 +21,90 @@
 #ifndef L10N_LANGUAGECOLLECTION_P_H
 #define L10N_LANGUAGECOLLECTION_P_H
 
-#include <QApt/Backend>
+#include <QAtomicInt>
+#include <QFutureWatcher>
+#include <QHash>
+#include <QList>
+#include <QPointer>
+#include <QTimer>
+
+#include "l10n_dpkgstatus_p.h"
+#include "l10n_languageinfo.h"
+#include "l10n_pkgdepends_p.h"
+
+class QFileSystemWatcher;
 
 namespace Kubuntu {
 
+class Language;
+class LanguageCollection;
+class PackageProvider;
+
 class LanguageCollectionPrivate
 {
 public:
-    LanguageCollectionPrivate();
+    LanguageCollectionPrivate(LanguageCollection *q);
+
+    /** Slot handling a finished support check of a single Language. */
+    void supportCheckResultReady(int index);
+
+    /** Slot handling the end of a checkSupport run. */
+    void supportCheckFinished();
+
+    /** Starts checking all pendingLanguages. */
+    void startSupportCheck();
+
+    /** Slot handling changes of the dpkg status file; (re)starts statusTimer. */
+    void statusFileChanged();
+
+    /** Slot re-evaluating all Languages affected by dpkg status changes. */
+    void updateSupportStatus();
 
-    QApt::Backend backend;
+    /** Rebuilds supportIndex from the relevant packages of all Languages. */
+    void rebuildSupportIndex();
+
+    /**
+     * \returns infos of all available languages, only queried again from the
+     * provider once its package states changed
+     */
+    const QList<LanguageInfo> &allLanguageInfos();
+
+    LanguageCollection *const q_ptr;
+    Q_DECLARE_PUBLIC(LanguageCollection)
+
+    /** Shared with all Languages of the collection. */
+    PackageProvider *provider;
 
     bool initalized;
+
+    /** One Language per KDE language code. \see LanguageCollection::language */
+    QHash<QString, QPointer<Language> > languageInstances;
+
+    /** \see allLanguageInfos */
+    QList<LanguageInfo> languageInfos;
+    /** PackageProvider::generation the languageInfos are based on. */
+    int languageInfosGeneration;
+    bool languageInfosValid;
+
+    QFutureWatcher<bool> supportWatcher;
+    /** Whether supportChecked is still to be emitted. */
+    bool supportCheckRunning;
+    QList<Language *> checkedLanguages;
+    /** Passed to checkSupport while a check was running, checked next. */
+    QSet<Language *> pendingLanguages;
+    QSet<Language *> incompleteLanguages;
+
+    /** Watches the dpkg status file, only set when watching is enabled. */
+    QFileSystemWatcher *statusWatcher;
+    /** Compresses the burst of status changes during an apt run. */
+    QTimer statusTimer;
+    /** Snapshots the current support states are based on. */
+    DpkgStatus::Ptr watchedStatus;
+    PkgDepends::Ptr watchedPkgDepends;
+    /** Reverse index of package name to Languages depending on it. */
+    QHash<QString, QList<QPointer<Language> > > supportIndex;
+    /** Set whenever a Language of the collection got (re)evaluated. */
+    QAtomicInt supportIndexDirty;
 };
 
 } // namespace Kubuntu
@@ -0,0 +1,103 @@
+/*
+  Copyright (C) 2015 Harald Sitter <sitter@kde.org>
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) version 3, or any
+  later version accepted by the membership of KDE e.V. (or its
+  successor approved by the membership of KDE e.V.), which shall
+  act as a proxy defined in Section 6 of version 3 of the license.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "l10n_languageinfo.h"
+
+#include <QSharedData>
+
+#include "l10n_language.h"
+
+namespace Kubuntu {
+
+class LanguageInfoData : public QSharedData
+{
+public:
+    LanguageInfoData() : installed(false) {}
+
+    QString kdeLanguage;
+    QString kdePackage;
+    bool installed;
+};
+
+// Shared by all invalid infos, so failed lookups do not allocate.
+struct NullLanguageInfo
+{
+    NullLanguageInfo() : d(new LanguageInfoData) {}
+    QSharedDataPointer<LanguageInfoData> d;
+};
+
+Q_GLOBAL_STATIC(NullLanguageInfo, s_nullLanguageInfo)
+
+LanguageInfo::LanguageInfo()
+    : d(s_nullLanguageInfo()->d)
+{
+}
+
+LanguageInfo::LanguageInfo(const QString &kdeLanguageCode, const QString &kdePackageCode,
+                           bool installed)
+    : d(new LanguageInfoData)
+{
+    d->kdeLanguage = kdeLanguageCode;
+    d->kdePackage = kdePackageCode;
+    d->installed = installed;
+}
+
+LanguageInfo::LanguageInfo(const LanguageInfo &other)
+    : d(other.d)
+{
+}
+
+LanguageInfo::~LanguageInfo()
+{
+}
+
+LanguageInfo &LanguageInfo::operator=(const LanguageInfo &other)
+{
+    d = other.d;
+    return *this;
+}
+
+bool LanguageInfo::isValid() const
+{
+    return !d->kdeLanguage.isEmpty();
+}
+
+QString LanguageInfo::kdeLanguageCode() const
+{
+    return d->kdeLanguage;
+}
+
+QString LanguageInfo::kdePackageCode() const
+{
+    return d->kdePackage;
+}
+
+QString LanguageInfo::ubuntuPackageCode() const
+{
+    // Derived on demand, most callers only ever look at the KDE code.
+    return Language::ubuntuPackageCodeForKdeCode(d->kdeLanguage);
+}
+
+bool LanguageInfo::isInstalled() const
+{
+    return d->installed;
+}
+
+} // namespace Kubuntu
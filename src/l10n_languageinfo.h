@@ -0,0 +1,81 @@
+/*
+  Copyright (C) 2015 Harald Sitter <sitter@kde.org>
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) version 3, or any
+  later version accepted by the membership of KDE e.V. (or its
+  successor approved by the membership of KDE e.V.), which shall
+  act as a proxy defined in Section 6 of version 3 of the license.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef KUBUNTU_L10N_LANGUAGEINFO_H
+#define KUBUNTU_L10N_LANGUAGEINFO_H
+
+#include "export.h"
+
+#include <QSharedDataPointer>
+#include <QString>
+
+namespace Kubuntu {
+
+class LanguageInfoData;
+
+/**
+ * \brief Lightweight description of a language known to a LanguageCollection.
+ *
+ * LanguageInfos are plain values obtained through
+ * LanguageCollection::languageInfos, they are cheap to create and copy and do
+ * not touch the package system after the query. Use them to list or look up
+ * languages and only get a Language through LanguageCollection::language
+ * once packages need managing.
+ */
+class KUBUNTU_EXPORT LanguageInfo
+{
+public:
+    /** Constructs an invalid info. */
+    LanguageInfo();
+    LanguageInfo(const LanguageInfo &other);
+    ~LanguageInfo();
+    LanguageInfo &operator=(const LanguageInfo &other);
+
+    /** \returns \c false for default constructed infos, e.g. of failed lookups */
+    bool isValid() const;
+
+    /** \returns the KDE language code (e.g. ca@valencia) */
+    QString kdeLanguageCode() const;
+
+    /** \returns the KDE package code (e.g. ca-valencia) */
+    QString kdePackageCode() const;
+
+    /** \returns the Ubuntu package code (e.g. ca) */
+    QString ubuntuPackageCode() const;
+
+    /**
+     * \returns \c true if the language's KDE translations are installed,
+     * \c false if they are only available. This does not tell whether support
+     * is complete \see Language::isSupportComplete
+     */
+    bool isInstalled() const;
+
+private:
+    friend class LanguageCollection;
+    friend class LanguageCollectionPrivate;
+    LanguageInfo(const QString &kdeLanguageCode, const QString &kdePackageCode,
+                 bool installed);
+
+    QSharedDataPointer<LanguageInfoData> d;
+};
+
+} // namespace Kubuntu
+
+#endif // KUBUNTU_L10N_LANGUAGEINFO_H
@@ -20,15 +20,19 @@
 
 #include "l10n_locale.h"
 
+#include "l10n_debug_p.h"
 #include "l10n_language.h"
+#include "l10n_language_p.h"
+#include "l10n_pkgdepends_p.h"
+#include "l10n_systemlocales_p.h"
 
 #include <KConfigGroup>
 #include <KSharedConfig>
 
-#include <QDebug>
 #include <QDir>
+#include <QHash>
 #include <QFileInfo>
-#include <QProcess>
+#include <QMutexLocker>
 
 namespace Kubuntu {
 
@@ -42,6 +46,9 @@ public:
 
     void init(LanguagePtrList _languages, QString _country);
 
+    /** \returns the private of every Language. */
+    QList<LanguagePrivate *> languagePrivates() const;
+
     LanguagePtrList languages;
 
     QString country;
@@ -56,7 +63,17 @@ LocalePrivate::LocalePrivate()
 
 LocalePrivate::~LocalePrivate()
 {
-    qDeleteAll(languages);
+    // Lists may contain the same Language more than once.
+    qDeleteAll(languages.toSet());
+}
+
+QList<LanguagePrivate *> LocalePrivate::languagePrivates() const
+{
+    QList<LanguagePrivate *> privates;
+    privates.reserve(languages.size());
+    foreach (Language *language, languages)
+        privates.append(language->d_func());
+    return privates;
 }
 
 void LocalePrivate::init(LanguagePtrList _languages, QString _country)
@@ -66,7 +83,7 @@ void LocalePrivate::init(LanguagePtrList _languages, QString _country)
 
     // Parse additional stuff out of the main language's kde code.
     QString mainLanguage = _languages.at(0)->kdeLanguageCode();
-    qDebug() << mainLanguage;
+    qCDebug(KUBUNTU_L10N_LOCALE) << mainLanguage;
     // Get variant.
     if (mainLanguage.contains(QChar('@'))) {
         QStringList components = mainLanguage.split(QChar('@'));
@@ -127,10 +144,14 @@ Locale::Locale(const QList<QString> &kdeLanguageCodes, const QString &country)
 {
     Q_D(Locale);
 
-    qDebug() << kdeLanguageCodes;
+    qCDebug(KUBUNTU_L10N_LOCALE) << kdeLanguageCodes;
     LanguagePtrList languages;
+    QHash<QString, Language *> languagesByCode;
     foreach (const QString &languageCode, kdeLanguageCodes) {
-        languages.append(new Language(languageCode));
+        Language *&language = languagesByCode[languageCode];
+        if (!language)
+            language = new Language(languageCode);
+        languages.append(language);
     }
 
     d->init(languages, country);
@@ -143,18 +164,29 @@ Locale::~Locale()
 QString Locale::systemLocaleString() const
 {
     Q_D(const Locale);
-    QString locale = d->languages.at(0)->systemLanguageCode();
-
-    if (!d->country.isEmpty())
-        locale.append(QString("_%1").arg(d->country.toUpper()));
+    // Assembled in place, this runs on every login.
+    const QString language = d->languages.at(0)->systemLanguageCode();
+    const QString country = d->country.toUpper(); // Shared if already upper case.
+    QString locale;
+    locale.reserve(language.size() + country.size() + d->encoding.size() + d->variant.size() + 10);
+    locale += language;
+
+    if (!country.isEmpty()) {
+        locale += QLatin1Char('_');
+        locale += country;
+    }
 
-    if (!d->encoding.isEmpty())
-        locale.append(QString(".%1").arg(d->encoding));
-    else // Encoding must not ever not be set as otherwise ISO nonsense comes up.
-        locale.append(QLatin1String(".UTF-8"));
+    if (!d->encoding.isEmpty()) {
+        locale += QLatin1Char('.');
+        locale += d->encoding;
+    } else { // Encoding must not ever not be set as otherwise ISO nonsense comes up.
+        locale += QLatin1String(".UTF-8");
+    }
 
-    if (!d->variant.isEmpty())
-        locale.append(QString("@%1").arg(d->variant));
+    if (!d->variant.isEmpty()) {
+        locale += QLatin1Char('@');
+        locale += d->variant;
+    }
 
     return locale;
 }
@@ -163,13 +195,15 @@ QList<QString> Locale::systemLanguages() const
 {
     Q_D(const Locale);
     QStringList list;
+    list.reserve(d->languages.size() + 1);
     foreach (Language *language, d->languages) {
-        if (list.isEmpty() || list.last() != language->systemLanguageCode())
-            list.append(language->systemLanguageCode());
+        const QString code = language->systemLanguageCode();
+        if (list.isEmpty() || list.last() != code)
+            list.append(code);
     }
     // Must always end with en.
     if (list.isEmpty() || list.last() != QLatin1String("en"))
-        list.append("en");
+        list.append(QStringLiteral("en"));
     return list;
 }
 
@@ -178,33 +212,46 @@ QString Locale::systemLanguagesString() const
     return QStringList(systemLanguages()).join(QChar(':'));
 }
 
-// NOTE: not public as there is no external use for this right now
-static bool isLocaleStringValid(const QString &locale)
+bool Locale::isSupportComplete()
 {
-    QProcess process;
-    process.start(QLatin1String("locale"), QStringList() << QLatin1String("-a"));
-    bool finished = process.waitForFinished(30 * 1000); // If locale takes more than 30 secs something is very wrong
-    if (!finished || process.exitStatus() != QProcess::NormalExit || process.exitCode() != 0) {
+    Q_D(Locale);
+
+    // Like Language, known missing packages stay missing until installed.
+    if (!missingPackages().isEmpty())
         return false;
+
+    const PkgDepends::Ptr pkgDepends = PkgDepends::system();
+    if (!pkgDepends->isValid()) {
+        return true; // Must assume support is complete if we can't read the dep file :S
     }
 
-    // We need to split the encoding from the locale as there's different
-    // formats floating around as supported (e.g. utf-8 vs. utf8)
-    // Also we only support utf-8 anyway, so it doesn't matter much as we assume
-    // it is always supported on Kubuntu systems.
-    const QString lowerLocale = locale.toLower().split(QChar('.')).first();
-    while (process.canReadLine()) {
-        QString line = QString(process.readLine()).remove(QChar('\n'));
-        line = line.split(QChar('.')).first();
-        line = line.toLower();
-        if (line == lowerLocale) {
-            return true;
-        }
+    LanguagePrivate::evaluateSupport(d->languagePrivates(), *pkgDepends);
+    return missingPackages().isEmpty();
+}
+
+QStringList Locale::missingPackages() const
+{
+    Q_D(const Locale);
+    QSet<QString> missing;
+    foreach (LanguagePrivate *language, d->languagePrivates()) {
+        QMutexLocker locker(&language->mutex);
+        missing.unite(language->missingPackages);
     }
+    return missing.toList();
+}
 
-    // If locale -a didn't give a perfect match for the defined locale we must
-    // assume it is invalid.
-    return false;
+Language *Locale::completeSupport()
+{
+    Q_D(Locale);
+    const QStringList missing = missingPackages();
+    if (missing.isEmpty())
+        return nullptr;
+
+    // Signals of a transaction that is already running say nothing about
+    // these packages.
+    if (!d->languagePrivates().first()->completeSupport(missing, d->languages))
+        return nullptr;
+    return d->languages.at(0);
 }
 
 // TODO: we likely should introduce GUI backing for only partially applying
@@ -218,7 +265,7 @@ bool Locale::writeToFile(const QString &filePath)
 
     QFile file(filePath);
     if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
-        qDebug() << "Couldn't open file for writing:" << filePath;
+        qCWarning(KUBUNTU_L10N_LOCALE) << "Couldn't open file for writing:" << filePath;
         return false;
     }
 
@@ -234,10 +281,11 @@ bool Locale::writeToFile(const QString &filePath)
     // language-only identifiers (e.g. de).
     // NOTE: LANGUAGE can contain any old nonsense as it has a built-in fallback
     //       logic and we always force en as final option explicitly.
-    qDebug() << QString("export LANGUAGE=%1").arg(systemLanguagesString());
+    qCDebug(KUBUNTU_L10N_LOCALE) << QString("export LANGUAGE=%1").arg(systemLanguagesString());
     stream << QString("export LANGUAGE=%1").arg(systemLanguagesString()) << endl;
-    if (isLocaleStringValid(systemLocaleString())) {
-        qDebug() << QString("export LANG=%1").arg(systemLocaleString());
+    // locale -a is only queried once per process.
+    if (SystemLocales::isAvailable(systemLocaleString())) {
+        qCDebug(KUBUNTU_L10N_LOCALE) << QString("export LANG=%1").arg(systemLocaleString());
         stream << QString("export LANG=%1").arg(systemLocaleString()) << endl;
         static QStringList lcVariables;
         if (lcVariables.isEmpty()) {
@@ -252,9 +300,12 @@ bool Locale::writeToFile(const QString &filePath)
                         << QLatin1String("LC_MEASUREMENT");
         }
         foreach (const QString &variable, lcVariables) {
-            qDebug() << QString("export %1=%2").arg(variable, systemLocaleString());
+            qCDebug(KUBUNTU_L10N_LOCALE) << QString("export %1=%2").arg(variable, systemLocaleString());
             stream << QString("export %1=%2").arg(variable, systemLocaleString()) << endl;
         }
+    } else {
+        qCWarning(KUBUNTU_L10N_LOCALE) << systemLocaleString()
+                                       << "is not generated, only exporting LANGUAGE";
     }
 
     file.close();
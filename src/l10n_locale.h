@@ -25,6 +25,7 @@
 
 #include <QList>
 #include <QScopedPointer>
+#include <QStringList>
 
 namespace Kubuntu {
 
@@ -92,6 +93,33 @@ public:
     /** \returns the system languages string (e.g. de:fr:en); always ends with en */
     QString systemLanguagesString() const;
 
+    /**
+     * Checks support of all languages of the Locale. Unlike calling
+     * Language::isSupportComplete on each of them this only takes a single
+     * pass over the rules and checks shared trigger packages once.
+     *
+     * \returns \c true when all packages for all languages are installed or
+     * the actual state can not be detected.
+     */
+    bool isSupportComplete();
+
+    /**
+     * \returns the names of all packages any of the languages needs, without
+     * duplicates. \see isSupportComplete
+     */
+    QStringList missingPackages() const;
+
+    /**
+     * Installs the missing packages of all languages in a single transaction;
+     * async.
+     *
+     * \returns the first Language, whose supportComplete,
+     * supportCompletionFailed and supportCompletionProgress signals report on
+     * the transaction. nullptr if nothing is missing or the first Language
+     * is still busy installing packages, in which case nothing is started.
+     */
+    Language *completeSupport();
+
     /**
      * \brief Writes a set of locale exports to a file.
      * This will write sh style system locale exports to a file.
@@ -0,0 +1,154 @@
+/*
+  Copyright (C) 2015 Harald Sitter <sitter@kde.org>
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) version 3, or any
+  later version accepted by the membership of KDE e.V. (or its
+  successor approved by the membership of KDE e.V.), which shall
+  act as a proxy defined in Section 6 of version 3 of the license.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "l10n_localegenerationplan.h"
+
+#include <QFile>
+#include <QProcess>
+#include <QSaveFile>
+#include <QSet>
+
+#include "l10n_debug_p.h"
+#include "l10n_locale.h"
+#include "l10n_systemlocales_p.h"
+
+namespace Kubuntu {
+
+class LocaleGenerationPlanPrivate
+{
+public:
+    QSet<QString> missing;
+    QSet<QString> unsupported;
+};
+
+LocaleGenerationPlan::LocaleGenerationPlan()
+    : d_ptr(new LocaleGenerationPlanPrivate)
+{
+}
+
+LocaleGenerationPlan::~LocaleGenerationPlan()
+{
+}
+
+void LocaleGenerationPlan::addLocale(const Locale &locale)
+{
+    Q_D(LocaleGenerationPlan);
+    const QString systemLocale = locale.systemLocaleString();
+    if (SystemLocales::isAvailable(systemLocale))
+        return;
+    if (SystemLocales::isSupported(systemLocale))
+        d->missing.insert(systemLocale);
+    else
+        d->unsupported.insert(systemLocale);
+}
+
+bool LocaleGenerationPlan::isEmpty() const
+{
+    Q_D(const LocaleGenerationPlan);
+    return d->missing.isEmpty();
+}
+
+QStringList LocaleGenerationPlan::missingLocales() const
+{
+    Q_D(const LocaleGenerationPlan);
+    QStringList locales = d->missing.toList();
+    locales.sort();
+    return locales;
+}
+
+QStringList LocaleGenerationPlan::unsupportedLocales() const
+{
+    Q_D(const LocaleGenerationPlan);
+    QStringList locales = d->unsupported.toList();
+    locales.sort();
+    return locales;
+}
+
+bool LocaleGenerationPlan::writeLocaleGen(const QString &filePath) const
+{
+    Q_D(const LocaleGenerationPlan);
+
+    // Entries are "<locale> UTF-8", possibly commented out with "# ".
+    QSet<QString> pending;
+    foreach (const QString &locale, d->missing)
+        pending.insert(SystemLocales::normalized(locale));
+
+    QByteArray content;
+    QFile in(filePath);
+    if (in.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        while (!in.atEnd()) {
+            QByteArray line = in.readLine();
+            const QByteArray entry = line.startsWith('#') ? line.mid(1).simplified() : line.simplified();
+            const QList<QByteArray> fields = entry.split(' ');
+            if (fields.size() == 2 && fields.at(1) == "UTF-8") {
+                const QString locale = SystemLocales::normalized(QString::fromLatin1(fields.at(0)));
+                if (pending.remove(locale))
+                    line = entry + '\n';
+            }
+            content += line;
+        }
+        if (!content.isEmpty() && !content.endsWith('\n'))
+            content += '\n';
+    }
+
+    foreach (const QString &locale, missingLocales()) {
+        if (pending.contains(SystemLocales::normalized(locale)))
+            content += locale.toLatin1() + " UTF-8\n";
+    }
+
+    QSaveFile out(filePath);
+    if (!out.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        qCWarning(KUBUNTU_L10N_LOCALE) << "Couldn't open file for writing:" << filePath;
+        return false;
+    }
+    out.write(content);
+    return out.commit();
+}
+
+QStringList LocaleGenerationPlan::command() const
+{
+    // Ubuntu's locale-gen generates the locales passed as arguments, Debian's
+    // ignores them and regenerates everything enabled in locale.gen. Either
+    // way it is one run for the whole set.
+    return QStringList() << QLatin1String("locale-gen") << missingLocales();
+}
+
+bool LocaleGenerationPlan::execute(const QString &localeGenPath)
+{
+    if (isEmpty())
+        return true;
+
+    ScopedTimer timer(KUBUNTU_L10N_LOCALE(), "locale generation");
+    if (!writeLocaleGen(localeGenPath))
+        return false;
+
+    QStringList arguments = command();
+    const QString program = arguments.takeFirst();
+    const int exitCode = QProcess::execute(program, arguments);
+    // Whatever happened, locale -a may differ now.
+    SystemLocales::invalidate();
+    if (exitCode != 0) {
+        qCWarning(KUBUNTU_L10N_LOCALE) << program << "failed with" << exitCode;
+        return false;
+    }
+    return true;
+}
+
+} // namespace Kubuntu
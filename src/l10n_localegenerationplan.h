@@ -0,0 +1,98 @@
+/*
+  Copyright (C) 2015 Harald Sitter <sitter@kde.org>
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) version 3, or any
+  later version accepted by the membership of KDE e.V. (or its
+  successor approved by the membership of KDE e.V.), which shall
+  act as a proxy defined in Section 6 of version 3 of the license.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef KUBUNTU_L10N_LOCALEGENERATIONPLAN_H
+#define KUBUNTU_L10N_LOCALEGENERATIONPLAN_H
+
+#include "export.h"
+
+#include <QScopedPointer>
+#include <QStringList>
+
+namespace Kubuntu {
+
+class Locale;
+class LocaleGenerationPlanPrivate;
+
+/**
+ * \brief Generates all system locales a set of Locales needs in one go.
+ *
+ * Locale::writeToFile can only export LANG and LC_* if the system locale
+ * was generated. Running locale-gen is slow, so rather than generating
+ * locales one at a time all Locales are collected into a plan which then
+ * generates whatever is missing with a single regeneration.
+ *
+ * \code
+ * LocaleGenerationPlan plan;
+ * plan.addLocale(Locale());
+ * if (!plan.isEmpty())
+ *     plan.execute(); // Requires root.
+ * \endcode
+ */
+class KUBUNTU_EXPORT LocaleGenerationPlan
+{
+public:
+    /** Constructs an empty plan. */
+    LocaleGenerationPlan();
+
+    /** Destructor. */
+    ~LocaleGenerationPlan();
+
+    /** Adds the system locale of \p locale if it is not generated yet. */
+    void addLocale(const Locale &locale);
+
+    /** \returns \c true if there is nothing to generate */
+    bool isEmpty() const;
+
+    /** \returns the system locales to generate, sorted (e.g. de_AT.UTF-8) */
+    QStringList missingLocales() const;
+
+    /**
+     * \returns the system locales that are not generated but can not be
+     * generated either as the system does not know them (e.g. en_AT.UTF-8)
+     */
+    QStringList unsupportedLocales() const;
+
+    /**
+     * Enables all missing locales in a locale.gen file, uncommenting
+     * existing entries and appending the others.
+     * \returns \c false if the file could not be written
+     */
+    bool writeLocaleGen(const QString &filePath = QLatin1String("/etc/locale.gen")) const;
+
+    /** \returns program and arguments of the single regeneration */
+    QStringList command() const;
+
+    /**
+     * Writes the locale.gen entries and runs command(). Blocks until the
+     * generation finished.
+     * \returns \c true on success
+     */
+    bool execute(const QString &localeGenPath = QLatin1String("/etc/locale.gen"));
+
+private:
+    const QScopedPointer<LocaleGenerationPlanPrivate> d_ptr;
+    Q_DECLARE_PRIVATE(LocaleGenerationPlan)
+    Q_DISABLE_COPY(LocaleGenerationPlan)
+};
+
+} // namespace Kubuntu
+
+#endif // KUBUNTU_L10N_LOCALEGENERATIONPLAN_H
@@ -0,0 +1,150 @@
+/*
+  Copyright (C) 2015 Harald Sitter <sitter@kde.org>
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) version 3, or any
+  later version accepted by the membership of KDE e.V. (or its
+  successor approved by the membership of KDE e.V.), which shall
+  act as a proxy defined in Section 6 of version 3 of the license.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "l10n_memorypackageprovider_p.h"
+
+#include <QFile>
+#include <QReadLocker>
+#include <QWriteLocker>
+
+namespace Kubuntu {
+
+MemoryPackageProvider::MemoryPackageProvider(QObject *parent)
+    : PackageProvider(parent)
+{
+}
+
+MemoryPackageProvider::~MemoryPackageProvider()
+{
+}
+
+bool MemoryPackageProvider::load(const QString &filePath)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+        return false;
+
+    QWriteLocker locker(&m_lock);
+    while (!file.atEnd()) {
+        const QByteArray line = file.readLine().simplified();
+        if (line.isEmpty() || line.startsWith('#'))
+            continue;
+
+        const QList<QByteArray> fields = line.split(' ');
+        const bool installed = fields.size() > 1 && fields.at(1) == "installed";
+        m_packages.insert(QString::fromLatin1(fields.at(0)), installed);
+    }
+    markChanged();
+    return true;
+}
+
+bool MemoryPackageProvider::loadControlFile(const QString &filePath)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+        return false;
+
+    QWriteLocker locker(&m_lock);
+    QString name;
+    bool installed = false;
+    while (true) {
+        const bool atEnd = file.atEnd();
+        // Not trimmed at the front, continuation lines start with a space.
+        const QByteArray line = atEnd ? QByteArray() : file.readLine();
+        if (line.trimmed().isEmpty()) { // End of stanza.
+            // A package may be listed by several lists, installed wins.
+            if (!name.isEmpty() && (installed || !m_packages.contains(name)))
+                m_packages.insert(name, installed);
+            name.clear();
+            installed = false;
+            if (atEnd)
+                break;
+        } else if (line.startsWith("Package:")) {
+            name = QString::fromLatin1(line.mid(8).trimmed());
+        } else if (line.startsWith("Status:")) {
+            installed = line.trimmed().endsWith(" installed");
+        }
+    }
+    markChanged();
+    return true;
+}
+
+void MemoryPackageProvider::addPackage(const QString &name, bool installed)
+{
+    QWriteLocker locker(&m_lock);
+    m_packages.insert(name, installed);
+    markChanged();
+}
+
+void MemoryPackageProvider::clear()
+{
+    QWriteLocker locker(&m_lock);
+    m_packages.clear();
+    markChanged();
+}
+
+int MemoryPackageProvider::count() const
+{
+    QReadLocker locker(&m_lock);
+    return m_packages.size();
+}
+
+bool MemoryPackageProvider::init()
+{
+    return true;
+}
+
+bool MemoryPackageProvider::hasPackage(const QString &name)
+{
+    QReadLocker locker(&m_lock);
+    return m_packages.contains(name);
+}
+
+bool MemoryPackageProvider::isInstalled(const QString &name)
+{
+    QReadLocker locker(&m_lock);
+    return m_packages.value(name, false);
+}
+
+QStringList MemoryPackageProvider::packagesWithPrefix(const QString &prefix)
+{
+    QReadLocker locker(&m_lock);
+    QStringList names;
+    QMap<QString, bool>::const_iterator it = m_packages.lowerBound(prefix);
+    for (; it != m_packages.constEnd() && it.key().startsWith(prefix); ++it)
+        names.append(it.key());
+    return names;
+}
+
+PackageTransaction *MemoryPackageProvider::commitInstall(const QStringList &names)
+{
+    {
+        QWriteLocker locker(&m_lock);
+        foreach (const QString &name, names) {
+            QMap<QString, bool>::iterator it = m_packages.find(name);
+            if (it != m_packages.end())
+                it.value() = true;
+        }
+        markChanged();
+    }
+    return new PackageTransaction(this);
+}
+
+} // namespace Kubuntu
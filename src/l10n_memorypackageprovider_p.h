@@ -0,0 +1,85 @@
+/*
+  Copyright (C) 2015 Harald Sitter <sitter@kde.org>
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) version 3, or any
+  later version accepted by the membership of KDE e.V. (or its
+  successor approved by the membership of KDE e.V.), which shall
+  act as a proxy defined in Section 6 of version 3 of the license.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef L10N_MEMORYPACKAGEPROVIDER_P_H
+#define L10N_MEMORYPACKAGEPROVIDER_P_H
+
+#include <QMap>
+#include <QReadWriteLock>
+
+#include "l10n_packageprovider_p.h"
+
+namespace Kubuntu {
+
+/**
+ * Package state kept entirely in memory, for tests, benchmarks and offline
+ * audits that must not depend on the APT cache of the machine they run on.
+ *
+ * Installs always succeed and simply mark the packages installed.
+ */
+class KUBUNTU_TESTS_EXPORT MemoryPackageProvider : public PackageProvider
+{
+    Q_OBJECT
+public:
+    explicit MemoryPackageProvider(QObject *parent = nullptr);
+    virtual ~MemoryPackageProvider();
+
+    /**
+     * Adds the packages listed in a fixture file. Every line holds a package
+     * name, optionally followed by \c installed. Empty lines and lines
+     * starting with # are ignored.
+     *
+     * \returns \c false if the file could not be read
+     */
+    bool load(const QString &filePath);
+
+    /**
+     * Adds the packages of a deb822 control file such as dpkg's status file
+     * or an APT Packages list. Stanzas with a Status field count as
+     * installed if the status says so, all others as available.
+     *
+     * \returns \c false if the file could not be read
+     */
+    bool loadControlFile(const QString &filePath);
+
+    /** Adds or replaces a single package. */
+    void addPackage(const QString &name, bool installed = false);
+
+    /** Forgets all packages. */
+    void clear();
+
+    /** \returns the number of known packages */
+    int count() const;
+
+    virtual bool init() Q_DECL_OVERRIDE;
+    virtual bool hasPackage(const QString &name) Q_DECL_OVERRIDE;
+    virtual bool isInstalled(const QString &name) Q_DECL_OVERRIDE;
+    virtual QStringList packagesWithPrefix(const QString &prefix) Q_DECL_OVERRIDE;
+    virtual PackageTransaction *commitInstall(const QStringList &names) Q_DECL_OVERRIDE;
+
+private:
+    mutable QReadWriteLock m_lock;
+    /** Package name to installed state; ordered for prefix lookups. */
+    QMap<QString, bool> m_packages;
+};
+
+} // namespace Kubuntu
+
+#endif // L10N_MEMORYPACKAGEPROVIDER_P_H
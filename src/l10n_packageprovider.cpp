@@ -0,0 +1,105 @@
+/*
+  Copyright (C) 2015 Harald Sitter <sitter@kde.org>
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) version 3, or any
+  later version accepted by the membership of KDE e.V. (or its
+  successor approved by the membership of KDE e.V.), which shall
+  act as a proxy defined in Section 6 of version 3 of the license.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "l10n_packageprovider_p.h"
+
+#include <QAtomicPointer>
+#include <QMetaObject>
+
+namespace Kubuntu {
+
+static QAtomicPointer<PackageProvider> s_defaultProvider;
+
+PackageTransaction::PackageTransaction(QObject *parent)
+    : QObject(parent)
+    , m_finished(false)
+{
+}
+
+PackageTransaction::~PackageTransaction()
+{
+}
+
+void PackageTransaction::run()
+{
+    QMetaObject::invokeMethod(this, "finish", Qt::QueuedConnection, Q_ARG(bool, true));
+}
+
+void PackageTransaction::finish(bool success)
+{
+    if (m_finished)
+        return;
+    m_finished = true;
+
+    if (success)
+        emit progressChanged(100);
+    emit finished(success);
+    deleteLater();
+}
+
+PackageProvider::PackageProvider(QObject *parent)
+    : QObject(parent)
+{
+}
+
+PackageProvider::~PackageProvider()
+{
+    s_defaultProvider.testAndSetOrdered(this, nullptr);
+}
+
+PackageProvider *PackageProvider::defaultProvider()
+{
+    return s_defaultProvider.loadAcquire();
+}
+
+void PackageProvider::setDefaultProvider(PackageProvider *provider)
+{
+    s_defaultProvider.storeRelease(provider);
+}
+
+void PackageProvider::refresh()
+{
+}
+
+void PackageProvider::reload()
+{
+}
+
+bool PackageProvider::isIndexUpdated()
+{
+    return true;
+}
+
+void PackageProvider::updateIndex()
+{
+    QMetaObject::invokeMethod(this, "indexUpdated", Qt::QueuedConnection);
+}
+
+int PackageProvider::generation() const
+{
+    return m_generation.loadAcquire();
+}
+
+void PackageProvider::markChanged()
+{
+    m_generation.ref();
+}
+
+} // namespace Kubuntu
@@ -0,0 +1,152 @@
+/*
+  Copyright (C) 2015 Harald Sitter <sitter@kde.org>
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) version 3, or any
+  later version accepted by the membership of KDE e.V. (or its
+  successor approved by the membership of KDE e.V.), which shall
+  act as a proxy defined in Section 6 of version 3 of the license.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef L10N_PACKAGEPROVIDER_P_H
+#define L10N_PACKAGEPROVIDER_P_H
+
+#include "export.h"
+
+#include <QAtomicInt>
+#include <QObject>
+#include <QStringList>
+
+namespace Kubuntu {
+
+/**
+ * An install started through PackageProvider::commitInstall. Transactions
+ * delete themselves once finished.
+ */
+class KUBUNTU_TESTS_EXPORT PackageTransaction : public QObject
+{
+    Q_OBJECT
+public:
+    explicit PackageTransaction(QObject *parent = nullptr);
+    virtual ~PackageTransaction();
+
+    /**
+     * Starts the transaction. The default implementation finishes
+     * successfully once control returns to the event loop.
+     */
+    virtual void run();
+
+signals:
+    /** \param progress Progress between 0 and 100 */
+    void progressChanged(int progress);
+
+    /** Emitted exactly once when the transaction is done. */
+    void finished(bool success);
+
+protected slots:
+    /** Emits finished unless that already happened and schedules deletion. */
+    void finish(bool success);
+
+private:
+    bool m_finished;
+};
+
+/**
+ * Source of package state for Languages and LanguageCollections.
+ *
+ * By default everything is backed by QApt (and dpkg's status file), through
+ * setDefaultProvider a different implementation may be injected to run
+ * support checks without an APT cache, e.g. a MemoryPackageProvider for tests
+ * and benchmarks.
+ *
+ * Lookup functions must be safe to call from multiple threads at once.
+ */
+class KUBUNTU_TESTS_EXPORT PackageProvider : public QObject
+{
+    Q_OBJECT
+public:
+    explicit PackageProvider(QObject *parent = nullptr);
+    virtual ~PackageProvider();
+
+    /**
+     * \returns the provider used instead of QApt by all Languages and
+     * LanguageCollections created from now on, nullptr if none is set
+     */
+    static PackageProvider *defaultProvider();
+
+    /**
+     * Sets the process-wide provider override. Ownership is not transferred
+     * and the provider must outlive all users. nullptr restores QApt.
+     */
+    static void setDefaultProvider(PackageProvider *provider);
+
+    /**
+     * Opens the package state if that did not happen yet.
+     * \returns \c false if the state can not be obtained at all
+     */
+    virtual bool init() = 0;
+
+    /** \returns \c true if a package by that name is known, installed or not */
+    virtual bool hasPackage(const QString &name) = 0;
+
+    /** \returns \c true if a package by that name is installed */
+    virtual bool isInstalled(const QString &name) = 0;
+
+    /** \returns names of all known packages starting with \p prefix */
+    virtual QStringList packagesWithPrefix(const QString &prefix) = 0;
+
+    /**
+     * Starts installing \p names. Names unknown to the provider are ignored.
+     * \returns the transaction, which still needs to be run, or nullptr
+     */
+    virtual PackageTransaction *commitInstall(const QStringList &names) = 0;
+
+    /**
+     * Cheaply brings installed states up to date with the system. Called
+     * before every support evaluation.
+     */
+    virtual void refresh();
+
+    /** Drops all cached state, e.g. after packages changed outside the library. */
+    virtual void reload();
+
+    /** \returns \c true if the package search index is up-to-date */
+    virtual bool isIndexUpdated();
+
+    /** Updates the search index; async \see indexUpdated */
+    virtual void updateIndex();
+
+    /**
+     * \returns a counter that moves on whenever known packages or installed
+     * states changed, results derived from them stay valid until it does
+     */
+    int generation() const;
+
+signals:
+    /** Emitted when the index update progress changes \see updateIndex */
+    void indexUpdateProgress(int progress);
+
+    /** Emitted when the index update is finished \see updateIndex */
+    void indexUpdated();
+
+protected:
+    /** Bumps generation(), implementations call this on every change. */
+    void markChanged();
+
+private:
+    QAtomicInt m_generation;
+};
+
+} // namespace Kubuntu
+
+#endif // L10N_PACKAGEPROVIDER_P_H
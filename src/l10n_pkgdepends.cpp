@@ -0,0 +1,137 @@
+/*
+  Copyright (C) 2015 Harald Sitter <sitter@kde.org>
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) version 3, or any
+  later version accepted by the membership of KDE e.V. (or its
+  successor approved by the membership of KDE e.V.), which shall
+  act as a proxy defined in Section 6 of version 3 of the license.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "l10n_pkgdepends_p.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QStringList>
+
+#include "l10n_debug_p.h"
+#include "l10n_stringtable_p.h"
+
+namespace Kubuntu {
+
+struct SystemPkgDepends
+{
+    QMutex mutex;
+    QString path;
+    PkgDepends::Ptr pkgDepends;
+};
+
+Q_GLOBAL_STATIC(SystemPkgDepends, s_systemPkgDepends)
+
+PkgDepends::PkgDepends()
+    : m_valid(false)
+{
+}
+
+PkgDepends::Ptr PkgDepends::system()
+{
+    SystemPkgDepends *system = s_systemPkgDepends();
+    QMutexLocker locker(&system->mutex);
+    const QString filePath = system->path.isEmpty() ? defaultPath() : system->path;
+    const QDateTime lastModified = QFileInfo(filePath).lastModified();
+    if (!system->pkgDepends || system->pkgDepends->lastModified() != lastModified)
+        system->pkgDepends = fromFile(filePath);
+    return system->pkgDepends;
+}
+
+PkgDepends::Ptr PkgDepends::fromFile(const QString &filePath)
+{
+    ScopedTimer timer(KUBUNTU_L10N_LANGUAGE(), "pkg_depends parsing",
+                      Statistics::PkgDependsLinesParsed);
+    QSharedPointer<PkgDepends> pkgDepends(new PkgDepends);
+
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+        return pkgDepends;
+
+    pkgDepends->m_valid = true;
+    pkgDepends->m_lastModified = QFileInfo(file).lastModified();
+
+    // List of valid column identifiers
+    QStringList columns;
+    columns << QLatin1String("tr") << QLatin1String("wa")
+            << QLatin1String("fn") << QLatin1String("in");
+    quint64 lines = 0;
+    while (!file.atEnd()) {
+        ++lines;
+        const QString line = QString::fromUtf8(file.readLine()).simplified();
+        const QStringList fields = line.split(QLatin1Char(':'));
+
+        // Check it's a valid depends line.
+        if (fields.size() < 4 || !columns.contains(fields.at(0)))
+            continue;
+
+        // Interned, so all parses and Languages share one copy of each.
+        PkgDependsRule rule;
+        rule.languageId = StringTable::intern(fields.at(1));
+        rule.triggerId = StringTable::intern(fields.at(2));
+        rule.packageId = StringTable::intern(fields.at(3));
+        rule.language = StringTable::string(rule.languageId);
+        rule.trigger = StringTable::string(rule.triggerId);
+        rule.package = StringTable::string(rule.packageId);
+        pkgDepends->m_rules.append(rule);
+    }
+    pkgDepends->m_rules.squeeze();
+    recordStatistics(Statistics::PkgDependsLinesParsed, lines);
+
+    return pkgDepends;
+}
+
+QString PkgDepends::path()
+{
+    SystemPkgDepends *system = s_systemPkgDepends();
+    QMutexLocker locker(&system->mutex);
+    return system->path.isEmpty() ? defaultPath() : system->path;
+}
+
+void PkgDepends::setPath(const QString &filePath)
+{
+    SystemPkgDepends *system = s_systemPkgDepends();
+    QMutexLocker locker(&system->mutex);
+    system->path = filePath;
+    system->pkgDepends.clear();
+}
+
+QString PkgDepends::defaultPath()
+{
+    return QLatin1String("/usr/share/language-selector/data/pkg_depends");
+}
+
+bool PkgDepends::isValid() const
+{
+    return m_valid;
+}
+
+QDateTime PkgDepends::lastModified() const
+{
+    return m_lastModified;
+}
+
+const QVector<PkgDependsRule> &PkgDepends::rules() const
+{
+    return m_rules;
+}
+
+} // namespace Kubuntu
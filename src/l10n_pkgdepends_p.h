@@ -0,0 +1,107 @@
+/*
+  Copyright (C) 2015 Harald Sitter <sitter@kde.org>
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) version 3, or any
+  later version accepted by the membership of KDE e.V. (or its
+  successor approved by the membership of KDE e.V.), which shall
+  act as a proxy defined in Section 6 of version 3 of the license.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef L10N_PKGDEPENDS_P_H
+#define L10N_PKGDEPENDS_P_H
+
+#include "export.h"
+
+#include <QDateTime>
+#include <QSharedPointer>
+#include <QString>
+#include <QVector>
+
+namespace Kubuntu {
+
+/** A single line of language-selector's pkg_depends. */
+struct PkgDependsRule
+{
+    /** Ubuntu language code this applies to; empty for all languages */
+    QString language;
+
+    /** Package that must be installed for this to apply; empty if always */
+    QString trigger;
+
+    /** Package name or prefix (e.g. kde-l10n-) to append language codes to */
+    QString package;
+
+    /** StringTable ids of language, trigger and package */
+    quint32 languageId;
+    quint32 triggerId;
+    quint32 packageId;
+
+    /** \returns \c true if package is a per-language prefix */
+    bool isPrefix() const { return package.endsWith(QLatin1Char('-')); }
+};
+
+/**
+ * Parsed pkg_depends. Instances are immutable, so a single parse can be shared
+ * by any number of support checks, including concurrent ones.
+ */
+class KUBUNTU_TESTS_EXPORT PkgDepends
+{
+public:
+    typedef QSharedPointer<const PkgDepends> Ptr;
+
+    /**
+     * \returns the shared rules of the system pkg_depends. The file is only
+     * parsed again when its modification time changed since the last call.
+     */
+    static Ptr system();
+
+    /** \returns new rules parsed from \p filePath */
+    static Ptr fromFile(const QString &filePath);
+
+    /** \returns the path system() reads, defaultPath() unless overridden */
+    static QString path();
+
+    /**
+     * Overrides the path system() reads, e.g. for fixtures or an alternative
+     * root. An empty path restores defaultPath().
+     */
+    static void setPath(const QString &filePath);
+
+    /** \returns the default path of the system pkg_depends file */
+    static QString defaultPath();
+
+    /** \returns \c false if the file could not be read */
+    bool isValid() const;
+
+    /** \returns modification time of the file at the time of parsing */
+    QDateTime lastModified() const;
+
+    /** \returns all valid rules in file order */
+    const QVector<PkgDependsRule> &rules() const;
+
+private:
+    PkgDepends();
+
+    bool m_valid;
+    QDateTime m_lastModified;
+    QVector<PkgDependsRule> m_rules;
+
+    Q_DISABLE_COPY(PkgDepends)
+};
+
+} // namespace Kubuntu
+
+Q_DECLARE_TYPEINFO(Kubuntu::PkgDependsRule, Q_MOVABLE_TYPE);
+
+#endif // L10N_PKGDEPENDS_P_H
@@ -0,0 +1,142 @@
+/*
+  Copyright (C) 2015 Harald Sitter <sitter@kde.org>
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) version 3, or any
+  later version accepted by the membership of KDE e.V. (or its
+  successor approved by the membership of KDE e.V.), which shall
+  act as a proxy defined in Section 6 of version 3 of the license.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "l10n_proxyresolver_p.h"
+
+#include <KConfig>
+#include <KConfigGroup>
+
+#include <QDateTime>
+#include <QFileInfo>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QStandardPaths>
+#include <QStringList>
+
+#include "l10n_debug_p.h"
+
+namespace Kubuntu {
+
+// Values of ProxyType in kioslaverc, see KProtocolManager::ProxyType.
+enum ProxyType {
+    UnsetProxy = -1, // no settings at all, not a KIO value
+    NoProxy = 0,
+    ManualProxy = 1,
+    PACProxy = 2,
+    WPADProxy = 3,
+    EnvVarProxy = 4
+};
+
+struct SystemProxySettings
+{
+    SystemProxySettings() : parsed(false), type(UnsetProxy) {}
+
+    QMutex mutex;
+    QString path;
+    bool parsed;
+    QDateTime lastModified;
+    int type;
+    QString httpProxy;
+};
+
+Q_GLOBAL_STATIC(SystemProxySettings, s_proxySettings)
+
+// KIO writes manual proxies as "http://host port" but also reads the
+// "http://host:port" written by older versions.
+static QString normalizedProxy(const QString &value)
+{
+    QString proxy = value.trimmed();
+    if (proxy.isEmpty())
+        return proxy;
+
+    const int space = proxy.lastIndexOf(QLatin1Char(' '));
+    if (space > 0)
+        proxy = proxy.left(space).trimmed() + QLatin1Char(':') + proxy.mid(space + 1);
+    if (!proxy.contains(QLatin1String("://")))
+        proxy.prepend(QLatin1String("http://"));
+    return proxy;
+}
+
+// \returns the value of the first set variable in the comma separated \p names
+static QString proxyFromEnvironment(const QString &names)
+{
+    foreach (const QString &name, names.split(QLatin1Char(','), QString::SkipEmptyParts)) {
+        const QByteArray value = qgetenv(name.trimmed().toLocal8Bit().constData());
+        if (!value.isEmpty())
+            return normalizedProxy(QString::fromLocal8Bit(value));
+    }
+    return QString();
+}
+
+QString ProxyResolver::httpProxy()
+{
+    SystemProxySettings *settings = s_proxySettings();
+    QMutexLocker locker(&settings->mutex);
+
+    const QString filePath = settings->path.isEmpty() ? defaultConfigPath() : settings->path;
+    const QDateTime lastModified = QFileInfo(filePath).lastModified();
+    if (!settings->parsed || settings->lastModified != lastModified) {
+        ScopedTimer timer(KUBUNTU_L10N_PACKAGES(), "proxy settings");
+        // SimpleConfig for overrides, otherwise the regular cascade so
+        // system-wide defaults in /etc/xdg apply as well.
+        const KConfig config(settings->path.isEmpty() ? QStringLiteral("kioslaverc") : settings->path,
+                             settings->path.isEmpty() ? KConfig::NoGlobals : KConfig::SimpleConfig);
+        const KConfigGroup group = config.group("Proxy Settings");
+        settings->type = group.readEntry("ProxyType", int(UnsetProxy));
+        settings->httpProxy = group.readEntry("httpProxy", QString());
+        settings->lastModified = lastModified;
+        settings->parsed = true;
+    }
+
+    // The environment is not cached, it is cheap to read and may be set
+    // after the first transaction.
+    switch (settings->type) {
+    case ManualProxy:
+        return normalizedProxy(settings->httpProxy);
+    case EnvVarProxy:
+        return proxyFromEnvironment(settings->httpProxy);
+    case UnsetProxy:
+        return proxyFromEnvironment(QStringLiteral("http_proxy,HTTP_PROXY"));
+    }
+    return QString();
+}
+
+QString ProxyResolver::configPath()
+{
+    SystemProxySettings *settings = s_proxySettings();
+    QMutexLocker locker(&settings->mutex);
+    return settings->path.isEmpty() ? defaultConfigPath() : settings->path;
+}
+
+void ProxyResolver::setConfigPath(const QString &filePath)
+{
+    SystemProxySettings *settings = s_proxySettings();
+    QMutexLocker locker(&settings->mutex);
+    settings->path = filePath;
+    settings->parsed = false;
+}
+
+QString ProxyResolver::defaultConfigPath()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::GenericConfigLocation)
+            + QLatin1String("/kioslaverc");
+}
+
+} // namespace Kubuntu
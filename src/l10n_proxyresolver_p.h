@@ -0,0 +1,63 @@
+/*
+  Copyright (C) 2015 Harald Sitter <sitter@kde.org>
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) version 3, or any
+  later version accepted by the membership of KDE e.V. (or its
+  successor approved by the membership of KDE e.V.), which shall
+  act as a proxy defined in Section 6 of version 3 of the license.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef L10N_PROXYRESOLVER_P_H
+#define L10N_PROXYRESOLVER_P_H
+
+#include "export.h"
+
+#include <QString>
+
+namespace Kubuntu {
+
+/**
+ * Resolves the HTTP proxy configured for KIO, without linking KIO.
+ *
+ * Only what can be handed to an install transaction is supported: a manual
+ * proxy and proxies taken from environment variables. PAC and WPAD are
+ * treated as no proxy. If kioslaverc has no proxy settings at all the
+ * http_proxy environment variable is used, so processes outside a Plasma
+ * session behave like other tools.
+ *
+ * The settings are cached process-wide and only read again when the
+ * modification time of the user's kioslaverc changed since the last call.
+ */
+class KUBUNTU_TESTS_EXPORT ProxyResolver
+{
+public:
+    /** \returns the proxy URL for http, empty if none is to be used */
+    static QString httpProxy();
+
+    /** \returns the kioslaverc httpProxy() reads, defaultConfigPath() unless overridden */
+    static QString configPath();
+
+    /**
+     * Overrides the kioslaverc to read, e.g. for tests. An empty path
+     * restores the default lookup, which also includes system-wide files.
+     */
+    static void setConfigPath(const QString &filePath);
+
+    /** \returns the path of the user's kioslaverc */
+    static QString defaultConfigPath();
+};
+
+} // namespace Kubuntu
+
+#endif // L10N_PROXYRESOLVER_P_H
@@ -0,0 +1,288 @@
+/*
+  Copyright (C) 2015 Harald Sitter <sitter@kde.org>
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) version 3, or any
+  later version accepted by the membership of KDE e.V. (or its
+  successor approved by the membership of KDE e.V.), which shall
+  act as a proxy defined in Section 6 of version 3 of the license.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "l10n_qaptpackageprovider_p.h"
+
+#include <QApt/Transaction>
+
+#include <QFileInfo>
+#include <QMutexLocker>
+
+#include <algorithm>
+#include <clocale>
+
+#include "l10n_debug_p.h"
+#include "l10n_proxyresolver_p.h"
+
+namespace Kubuntu {
+
+QAptPackageTransaction::QAptPackageTransaction(QApt::Transaction *transaction,
+                                               QAptPackageProvider *provider)
+    : PackageTransaction(provider)
+    , m_transaction(transaction)
+    , m_provider(provider)
+    , m_failed(false)
+{
+    connect(m_transaction, SIGNAL(progressChanged(int)),
+            this, SIGNAL(progressChanged(int)));
+    connect(m_transaction, SIGNAL(finished(QApt::ExitStatus)),
+            this, SLOT(transactionFinished(QApt::ExitStatus)));
+    connect(m_transaction, SIGNAL(errorOccurred(QApt::ErrorCode)),
+            this, SLOT(transactionError()));
+}
+
+void QAptPackageTransaction::run()
+{
+    // Provide proxy/locale to the transaction
+    const QString proxy = ProxyResolver::httpProxy();
+    if (!proxy.isEmpty())
+        m_transaction->setProxy(proxy);
+
+    m_transaction->setLocale(QLatin1String(setlocale(LC_MESSAGES, 0)));
+
+    qCDebug(KUBUNTU_L10N_PACKAGES) << "start";
+    m_transaction->run();
+}
+
+void QAptPackageTransaction::transactionFinished(QApt::ExitStatus exitStatus)
+{
+    qCDebug(KUBUNTU_L10N_PACKAGES) << Q_FUNC_INFO << exitStatus;
+
+    // Reload cache to reset pending changes, this way error'd installs will not
+    // keep repeating for any subsequent attempts.
+    m_provider->reload();
+    finish(!m_failed && exitStatus == QApt::ExitSuccess);
+}
+
+void QAptPackageTransaction::transactionError()
+{
+    qCDebug(KUBUNTU_L10N_PACKAGES) << Q_FUNC_INFO;
+
+    // QApt still emits finished afterwards, which does the cleanup.
+    m_failed = true;
+}
+
+QAptPackageProvider::QAptPackageProvider(QObject *parent)
+    : PackageProvider(parent)
+    , m_initialized(false)
+    , m_initResult(false)
+    , m_indexChecked(false)
+    , m_indexUpdated(true)
+    , m_packageNamesValid(false)
+{
+    connect(&m_backend, SIGNAL(xapianUpdateProgress(int)),
+            this, SIGNAL(indexUpdateProgress(int)));
+    connect(&m_backend, SIGNAL(xapianUpdateFinished()),
+            this, SLOT(indexUpdateFinished()));
+}
+
+QAptPackageProvider::IndexStamp QAptPackageProvider::IndexStamp::current()
+{
+    // QApt considers the index outdated when the binary cache or the dpkg
+    // status are newer than it. The lists also change on apt update before
+    // anything rebuilt the cache.
+    IndexStamp stamp;
+    stamp.lists = QFileInfo(QLatin1String("/var/lib/apt/lists")).lastModified();
+    stamp.cache = QFileInfo(QLatin1String("/var/cache/apt/pkgcache.bin")).lastModified();
+    stamp.status = QFileInfo(DpkgStatus::path()).lastModified();
+    stamp.index = QFileInfo(QLatin1String("/var/lib/apt-xapian-index/update-timestamp")).lastModified();
+    return stamp;
+}
+
+bool QAptPackageProvider::IndexStamp::operator==(const IndexStamp &other) const
+{
+    return lists == other.lists && cache == other.cache &&
+            status == other.status && index == other.index;
+}
+
+QAptPackageProvider::~QAptPackageProvider()
+{
+}
+
+bool QAptPackageProvider::ensureInitialized()
+{
+    if (!m_initialized) {
+        ScopedTimer timer(KUBUNTU_L10N_PACKAGES(), "APT cache init",
+                          Statistics::BackendInitializations);
+        recordStatistics(Statistics::BackendInitializations);
+        m_initialized = true;
+        m_initResult = m_backend.init();
+    }
+    return m_initResult;
+}
+
+bool QAptPackageProvider::init()
+{
+    QMutexLocker locker(&m_mutex);
+    return ensureInitialized();
+}
+
+bool QAptPackageProvider::hasPackage(const QString &name)
+{
+    QMutexLocker locker(&m_mutex);
+    if (!ensureInitialized())
+        return false;
+    ScopedTimer timer(KUBUNTU_L10N_PACKAGES(), "package lookup", Statistics::PackageLookups);
+    recordStatistics(Statistics::PackageLookups);
+    return m_backend.package(name) != nullptr;
+}
+
+bool QAptPackageProvider::isInstalled(const QString &name)
+{
+    DpkgStatus::Ptr status;
+    {
+        QMutexLocker locker(&m_mutex);
+        if (!m_status)
+            m_status = DpkgStatus::system();
+        status = m_status;
+    }
+    // The snapshot is immutable, no need to hold the lock for the lookup.
+    if (status->isValid())
+        return status->isInstalled(name);
+
+    QMutexLocker locker(&m_mutex);
+    if (!ensureInitialized())
+        return false;
+    ScopedTimer timer(KUBUNTU_L10N_PACKAGES(), "package lookup", Statistics::PackageLookups);
+    recordStatistics(Statistics::PackageLookups);
+    QApt::Package *package = m_backend.package(name);
+    return package && !package->installedVersion().isEmpty();
+}
+
+QStringList QAptPackageProvider::packagesWithPrefix(const QString &prefix)
+{
+    QMutexLocker locker(&m_mutex);
+    if (!ensureInitialized())
+        return QStringList();
+
+    if (!m_packageNamesValid) {
+        // A scan of the in-memory cache is quick enough and unlike a xapian
+        // search neither needs the index opened nor up-to-date. Only done
+        // once per cache load, lookups are binary searches afterwards.
+        ScopedTimer timer(KUBUNTU_L10N_PACKAGES(), "package name index");
+        const QApt::PackageList packages = m_backend.availablePackages();
+        m_packageNames.clear();
+        m_packageNames.reserve(packages.size());
+        foreach (const QApt::Package *package, packages)
+            m_packageNames.append(QString(package->name()));
+        std::sort(m_packageNames.begin(), m_packageNames.end());
+        m_packageNamesValid = true;
+    }
+
+    ScopedTimer timer(KUBUNTU_L10N_PACKAGES(), "package search");
+    QStringList names;
+    QStringList::const_iterator it = std::lower_bound(m_packageNames.constBegin(),
+                                                      m_packageNames.constEnd(), prefix);
+    for (; it != m_packageNames.constEnd() && it->startsWith(prefix); ++it)
+        names.append(*it);
+    return names;
+}
+
+PackageTransaction *QAptPackageProvider::commitInstall(const QStringList &names)
+{
+    QMutexLocker locker(&m_mutex);
+    if (!ensureInitialized())
+        return nullptr;
+
+    QApt::PackageList packages;
+    recordStatistics(Statistics::PackageLookups, names.size());
+    foreach (const QString &name, names) {
+        QApt::Package *package = m_backend.package(name);
+        if (!package)
+            continue;
+        qCDebug(KUBUNTU_L10N_PACKAGES) << "installing" << name;
+        packages.append(package);
+    }
+    if (packages.isEmpty())
+        return nullptr;
+
+    m_backend.markPackages(packages, QApt::Package::ToInstall);
+    QApt::Transaction *transaction = m_backend.commitChanges();
+    if (!transaction)
+        return nullptr;
+    return new QAptPackageTransaction(transaction, this);
+}
+
+void QAptPackageProvider::refresh()
+{
+    const DpkgStatus::Ptr status = DpkgStatus::system();
+    QMutexLocker locker(&m_mutex);
+    if (status == m_status)
+        return;
+    m_status = status;
+    markChanged();
+}
+
+void QAptPackageProvider::reload()
+{
+    const DpkgStatus::Ptr status = DpkgStatus::system();
+    QMutexLocker locker(&m_mutex);
+    m_status = status;
+    markChanged();
+    // The APT cache has its own idea of installed states, which must not
+    // claim a freshly removed package is still installed.
+    if (m_initialized) {
+        ScopedTimer timer(KUBUNTU_L10N_PACKAGES(), "APT cache reload",
+                          Statistics::CacheReloads);
+        recordStatistics(Statistics::CacheReloads);
+        m_backend.reloadCache();
+        m_packageNamesValid = false;
+        m_packageNames.clear();
+    }
+}
+
+bool QAptPackageProvider::isIndexUpdated()
+{
+    const IndexStamp stamp = IndexStamp::current();
+    QMutexLocker locker(&m_mutex);
+    if (m_indexChecked && stamp == m_indexStamp)
+        return m_indexUpdated;
+
+    if (!ensureInitialized())
+        return true;
+    ScopedTimer timer(KUBUNTU_L10N_PACKAGES(), "xapian index check");
+    m_indexUpdated = !(m_backend.openXapianIndex() && m_backend.xapianIndexNeedsUpdate());
+    m_indexStamp = stamp;
+    m_indexChecked = true;
+    return m_indexUpdated;
+}
+
+void QAptPackageProvider::updateIndex()
+{
+    QMutexLocker locker(&m_mutex);
+    m_indexChecked = false;
+    if (ensureInitialized())
+        m_backend.updateXapianIndex();
+    else
+        PackageProvider::updateIndex();
+}
+
+void QAptPackageProvider::indexUpdateFinished()
+{
+    {
+        // The timestamp file may be written with a coarse resolution, do
+        // not rely on it having changed.
+        QMutexLocker locker(&m_mutex);
+        m_indexChecked = false;
+    }
+    emit indexUpdated();
+}
+
+} // namespace Kubuntu
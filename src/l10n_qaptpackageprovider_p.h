@@ -0,0 +1,123 @@
+/*
+  Copyright (C) 2015 Harald Sitter <sitter@kde.org>
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) version 3, or any
+  later version accepted by the membership of KDE e.V. (or its
+  successor approved by the membership of KDE e.V.), which shall
+  act as a proxy defined in Section 6 of version 3 of the license.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef L10N_QAPTPACKAGEPROVIDER_P_H
+#define L10N_QAPTPACKAGEPROVIDER_P_H
+
+#include <QApt/Backend>
+#include <QApt/Globals>
+
+#include <QDateTime>
+#include <QMutex>
+
+#include "l10n_dpkgstatus_p.h"
+#include "l10n_packageprovider_p.h"
+
+namespace QApt {
+class Transaction;
+}
+
+namespace Kubuntu {
+
+class QAptPackageProvider;
+
+/** Wraps a QApt::Transaction, resetting pending changes once it ended. */
+class QAptPackageTransaction : public PackageTransaction
+{
+    Q_OBJECT
+public:
+    QAptPackageTransaction(QApt::Transaction *transaction, QAptPackageProvider *provider);
+
+    virtual void run() Q_DECL_OVERRIDE;
+
+private slots:
+    void transactionFinished(QApt::ExitStatus exitStatus);
+    void transactionError();
+
+private:
+    QApt::Transaction *m_transaction;
+    QAptPackageProvider *m_provider;
+    /** Whether an error occurred, QApt may still report a successful exit. */
+    bool m_failed;
+};
+
+/**
+ * The system's package state. Installed states come from a dpkg status
+ * snapshot whenever possible, everything else from the APT cache, which is
+ * only opened on first use unless init() is called explicitly.
+ */
+class QAptPackageProvider : public PackageProvider
+{
+    Q_OBJECT
+public:
+    explicit QAptPackageProvider(QObject *parent = nullptr);
+    virtual ~QAptPackageProvider();
+
+    virtual bool init() Q_DECL_OVERRIDE;
+    virtual bool hasPackage(const QString &name) Q_DECL_OVERRIDE;
+    virtual bool isInstalled(const QString &name) Q_DECL_OVERRIDE;
+    virtual QStringList packagesWithPrefix(const QString &prefix) Q_DECL_OVERRIDE;
+    virtual PackageTransaction *commitInstall(const QStringList &names) Q_DECL_OVERRIDE;
+    virtual void refresh() Q_DECL_OVERRIDE;
+    virtual void reload() Q_DECL_OVERRIDE;
+    virtual bool isIndexUpdated() Q_DECL_OVERRIDE;
+    virtual void updateIndex() Q_DECL_OVERRIDE;
+
+private slots:
+    void indexUpdateFinished();
+
+private:
+    /**
+     * Modification times of everything the xapian freshness depends on.
+     * Comparing stamps only needs a few stat calls whereas asking QApt
+     * opens the index.
+     */
+    struct IndexStamp
+    {
+        static IndexStamp current();
+        bool operator==(const IndexStamp &other) const;
+
+        QDateTime lists;
+        QDateTime cache;
+        QDateTime status;
+        QDateTime index;
+    };
+
+    /** Opens the cache; m_mutex must be held. */
+    bool ensureInitialized();
+
+    /** Serializes backend access of concurrently evaluated Languages. */
+    QMutex m_mutex;
+    QApt::Backend m_backend;
+    bool m_initialized;
+    bool m_initResult;
+    DpkgStatus::Ptr m_status;
+    /** Result of the last index check and the state it was based on. */
+    bool m_indexChecked;
+    bool m_indexUpdated;
+    IndexStamp m_indexStamp;
+    /** All package names, sorted for prefix lookups; dropped on reload. */
+    QStringList m_packageNames;
+    bool m_packageNamesValid;
+};
+
+} // namespace Kubuntu
+
+#endif // L10N_QAPTPACKAGEPROVIDER_P_H
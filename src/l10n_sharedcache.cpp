@@ -0,0 +1,179 @@
+/*
+  Copyright (C) 2015 Harald Sitter <sitter@kde.org>
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) version 3, or any
+  later version accepted by the membership of KDE e.V. (or its
+  successor approved by the membership of KDE e.V.), which shall
+  act as a proxy defined in Section 6 of version 3 of the license.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "l10n_sharedcache_p.h"
+
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSaveFile>
+
+#include <string.h>
+#include <unistd.h>
+
+#include "l10n_debug_p.h"
+
+namespace Kubuntu {
+
+// Bump whenever the header or any payload layout changes.
+static const quint32 s_formatVersion = 2;
+static const char s_magic[8] = { 'K', 'L', '1', '0', 'N', 'C', 'A', 'C' };
+
+struct SharedCacheHeader
+{
+    char magic[8];
+    quint32 version;
+    quint32 keySize;
+    quint64 payloadSize;
+};
+
+static qint64 payloadOffset(quint32 keySize)
+{
+    return (qint64(sizeof(SharedCacheHeader)) + keySize + 7) & ~qint64(7);
+}
+
+struct SharedCacheSettings
+{
+    QMutex mutex;
+    QString directory;
+};
+
+Q_GLOBAL_STATIC(SharedCacheSettings, s_settings)
+
+SharedCacheFile::SharedCacheFile()
+    : m_file(nullptr)
+    , m_data(nullptr)
+    , m_size(0)
+{
+}
+
+SharedCacheFile::~SharedCacheFile()
+{
+    delete m_file; // Also unmaps.
+}
+
+bool SharedCache::isEnabled()
+{
+    return QFileInfo(directory()).isDir();
+}
+
+QString SharedCache::directory()
+{
+    SharedCacheSettings *settings = s_settings();
+    QMutexLocker locker(&settings->mutex);
+    if (!settings->directory.isEmpty())
+        return settings->directory;
+    const QString environment = QFile::decodeName(qgetenv("KUBUNTU_L10N_CACHE_DIR"));
+    return environment.isEmpty() ? QLatin1String("/run/kubuntu-l10n") : environment;
+}
+
+void SharedCache::setDirectory(const QString &path)
+{
+    SharedCacheSettings *settings = s_settings();
+    QMutexLocker locker(&settings->mutex);
+    settings->directory = path;
+}
+
+QByteArray SharedCache::sourceKey(const QStringList &sourcePaths)
+{
+    QByteArray key;
+    foreach (const QString &path, sourcePaths) {
+        const QFileInfo info(path);
+        key += QFile::encodeName(path);
+        key += '\0';
+        key += QByteArray::number(info.exists() ? info.lastModified().toMSecsSinceEpoch() : -1);
+        key += '\0';
+        key += QByteArray::number(info.size());
+        key += '\0';
+    }
+    return key;
+}
+
+SharedCache::FilePtr SharedCache::open(const QString &name, const QByteArray &key)
+{
+    const QString path = directory() + QLatin1Char('/') + name + QLatin1String(".cache");
+    const QFileInfo info(path);
+    if (!info.exists())
+        return FilePtr();
+    // Anyone else could make us believe arbitrary package states.
+    if (info.ownerId() != 0 && info.ownerId() != uint(getuid())) {
+        qCWarning(KUBUNTU_L10N_PACKAGES) << "ignoring cache not owned by root or us" << path;
+        return FilePtr();
+    }
+
+    QSharedPointer<SharedCacheFile> cache(new SharedCacheFile);
+    cache->m_file = new QFile(path);
+    if (!cache->m_file->open(QIODevice::ReadOnly))
+        return FilePtr();
+
+    const qint64 size = cache->m_file->size();
+    if (size < qint64(sizeof(SharedCacheHeader)))
+        return FilePtr();
+    const uchar *data = cache->m_file->map(0, size);
+    if (!data)
+        return FilePtr();
+
+    SharedCacheHeader header;
+    memcpy(&header, data, sizeof(header));
+    if (memcmp(header.magic, s_magic, sizeof(s_magic)) != 0 ||
+            header.version != s_formatVersion ||
+            header.keySize != quint32(key.size()) ||
+            payloadOffset(header.keySize) + qint64(header.payloadSize) != size ||
+            memcmp(data + sizeof(header), key.constData(), key.size()) != 0) {
+        qCDebug(KUBUNTU_L10N_PACKAGES) << "stale cache" << path;
+        return FilePtr();
+    }
+
+    cache->m_data = data + payloadOffset(header.keySize);
+    cache->m_size = header.payloadSize;
+    return cache;
+}
+
+bool SharedCache::write(const QString &name, const QByteArray &key, const QByteArray &payload)
+{
+    const QString dir = directory();
+    if (!QFileInfo(dir).isWritable())
+        return false;
+
+    QSaveFile file(dir + QLatin1Char('/') + name + QLatin1String(".cache"));
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+    // Readable by every session, including those of other users.
+    file.setPermissions(QFileDevice::ReadOwner | QFileDevice::WriteOwner |
+                        QFileDevice::ReadGroup | QFileDevice::ReadOther);
+
+    SharedCacheHeader header;
+    memcpy(header.magic, s_magic, sizeof(s_magic));
+    header.version = s_formatVersion;
+    header.keySize = key.size();
+    header.payloadSize = payload.size();
+
+    QByteArray padding(payloadOffset(header.keySize) - sizeof(header) - key.size(), '\0');
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    file.write(key);
+    file.write(padding);
+    file.write(payload);
+    return file.commit();
+}
+
+} // namespace Kubuntu
@@ -0,0 +1,108 @@
+/*
+  Copyright (C) 2015 Harald Sitter <sitter@kde.org>
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) version 3, or any
+  later version accepted by the membership of KDE e.V. (or its
+  successor approved by the membership of KDE e.V.), which shall
+  act as a proxy defined in Section 6 of version 3 of the license.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef L10N_SHAREDCACHE_P_H
+#define L10N_SHAREDCACHE_P_H
+
+#include "export.h"
+
+#include <QByteArray>
+#include <QSharedPointer>
+#include <QString>
+#include <QStringList>
+
+class QFile;
+
+namespace Kubuntu {
+
+/**
+ * A cache file mapped into memory. The payload stays valid for as long as
+ * the SharedCacheFile is referenced.
+ */
+class KUBUNTU_TESTS_EXPORT SharedCacheFile
+{
+public:
+    ~SharedCacheFile();
+
+    /** \returns the payload, aligned to 8 bytes */
+    const uchar *data() const { return m_data; }
+    qint64 size() const { return m_size; }
+
+private:
+    friend class SharedCache;
+    SharedCacheFile();
+    Q_DISABLE_COPY(SharedCacheFile)
+
+    QFile *m_file;
+    const uchar *m_data;
+    qint64 m_size;
+};
+
+/**
+ * Cross-process cache of parsed system state.
+ *
+ * Multiple sessions on the same machine, e.g. on terminal servers, would
+ * otherwise each parse the dpkg status and query the generated locales.
+ * Instead the first process writes the result into a versioned binary file
+ * and later ones map it read-only.
+ *
+ * Every file is keyed by the paths, modification times and sizes of its
+ * sources, a file is only used while all of them are unchanged. Files are
+ * replaced atomically. Only files owned by root or the current user are
+ * read, so sessions of different users share a cache written by root.
+ *
+ * The cache is optional and only used if its directory exists,
+ * /run/kubuntu-l10n unless overridden through the KUBUNTU_L10N_CACHE_DIR
+ * environment variable or setDirectory.
+ */
+class KUBUNTU_TESTS_EXPORT SharedCache
+{
+public:
+    typedef QSharedPointer<const SharedCacheFile> FilePtr;
+
+    /** \returns \c true if the cache directory exists */
+    static bool isEnabled();
+
+    /** \returns the cache directory */
+    static QString directory();
+
+    /** Overrides the cache directory. An empty path restores the default. */
+    static void setDirectory(const QString &path);
+
+    /** \returns a key identifying the current state of the \p sourcePaths */
+    static QByteArray sourceKey(const QStringList &sourcePaths);
+
+    /**
+     * \returns the mapped cache file \p name if it was written with \p key,
+     * nullptr if it does not exist, is stale or is not trustworthy
+     */
+    static FilePtr open(const QString &name, const QByteArray &key);
+
+    /**
+     * Atomically replaces the cache file \p name.
+     * \returns \c false if the file could not be written, e.g. because the
+     *          directory is not writable
+     */
+    static bool write(const QString &name, const QByteArray &key, const QByteArray &payload);
+};
+
+} // namespace Kubuntu
+
+#endif // L10N_SHAREDCACHE_P_H
@@ -0,0 +1,76 @@
+/*
+  Copyright (C) 2015 Harald Sitter <sitter@kde.org>
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) version 3, or any
+  later version accepted by the membership of KDE e.V. (or its
+  successor approved by the membership of KDE e.V.), which shall
+  act as a proxy defined in Section 6 of version 3 of the license.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "l10n_statistics.h"
+#include "l10n_statistics_p.h"
+
+#include <QAtomicInteger>
+
+namespace Kubuntu {
+
+// Constant-initialized, so usable from anywhere including static init.
+static QAtomicInteger<quint64> s_counts[Statistics::CounterCount];
+static QAtomicInteger<quint64> s_nsecs[Statistics::CounterCount];
+
+void recordStatistics(Statistics::Counter counter, quint64 count, quint64 nsecs)
+{
+    s_counts[counter].fetchAndAddRelaxed(count);
+    if (nsecs)
+        s_nsecs[counter].fetchAndAddRelaxed(nsecs);
+}
+
+Statistics Statistics::snapshot()
+{
+    Statistics statistics;
+    for (int i = 0; i < CounterCount; ++i) {
+        statistics.m_counts[i] = s_counts[i].load();
+        statistics.m_nsecs[i] = s_nsecs[i].load();
+    }
+    return statistics;
+}
+
+void Statistics::reset()
+{
+    for (int i = 0; i < CounterCount; ++i) {
+        s_counts[i].store(0);
+        s_nsecs[i].store(0);
+    }
+}
+
+Statistics::Statistics()
+{
+    Q_STATIC_ASSERT(int(CounterCount) <= int(Capacity));
+    for (int i = 0; i < Capacity; ++i) {
+        m_counts[i] = 0;
+        m_nsecs[i] = 0;
+    }
+}
+
+quint64 Statistics::count(Counter counter) const
+{
+    return m_counts[counter];
+}
+
+quint64 Statistics::nsecsElapsed(Counter counter) const
+{
+    return m_nsecs[counter];
+}
+
+} // namespace Kubuntu
@@ -0,0 +1,91 @@
+/*
+  Copyright (C) 2015 Harald Sitter <sitter@kde.org>
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) version 3, or any
+  later version accepted by the membership of KDE e.V. (or its
+  successor approved by the membership of KDE e.V.), which shall
+  act as a proxy defined in Section 6 of version 3 of the license.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef KUBUNTU_L10N_STATISTICS_H
+#define KUBUNTU_L10N_STATISTICS_H
+
+#include "export.h"
+
+#include <QtGlobal>
+
+namespace Kubuntu {
+
+/**
+ * \brief Snapshot of process-wide usage counters of the l10n classes.
+ *
+ * The library counts expensive operations, such as package lookups and
+ * reloads of the APT cache, as well as the time spent in them. This allows
+ * confirming that caching works without attaching a profiler.
+ *
+ * \code
+ * Statistics stats = Statistics::snapshot();
+ * stats.count(Statistics::CacheReloads);
+ * stats.nsecsElapsed(Statistics::CacheReloads);
+ * \endcode
+ *
+ * Counters are updated atomically, taking a snapshot does not lock or
+ * allocate. A Statistics is a plain value that may be copied freely.
+ */
+class KUBUNTU_EXPORT Statistics
+{
+public:
+    enum Counter {
+        /** Lines read from pkg_depends files */
+        PkgDependsLinesParsed,
+        /** Package lookups in the APT cache */
+        PackageLookups,
+        /** Initializations of an APT cache */
+        BackendInitializations,
+        /** Reloads of an APT cache */
+        CacheReloads,
+        /** Runs of locale -a to validate a locale */
+        LocaleQueries,
+        /** Language objects constructed; not timed */
+        LanguagesCreated,
+        /** Number of counters, not a counter itself */
+        CounterCount
+    };
+
+    /** \returns the current values of all counters */
+    static Statistics snapshot();
+
+    /** Sets all counters back to zero. */
+    static void reset();
+
+    /** Constructs a snapshot with all counters at zero. */
+    Statistics();
+
+    /** \returns how often \p counter was hit */
+    quint64 count(Counter counter) const;
+
+    /** \returns cumulative nanoseconds spent in \p counter */
+    quint64 nsecsElapsed(Counter counter) const;
+
+private:
+    // Leaves room for counters added later without changing the size.
+    enum { Capacity = 16 };
+
+    quint64 m_counts[Capacity];
+    quint64 m_nsecs[Capacity];
+};
+
+} // namespace Kubuntu
+
+#endif // KUBUNTU_L10N_STATISTICS_H
@@ -0,0 +1,34 @@
+/*
+  Copyright (C) 2015 Harald Sitter <sitter@kde.org>
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) version 3, or any
+  later version accepted by the membership of KDE e.V. (or its
+  successor approved by the membership of KDE e.V.), which shall
+  act as a proxy defined in Section 6 of version 3 of the license.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef L10N_STATISTICS_P_H
+#define L10N_STATISTICS_P_H
+
+#include "l10n_statistics.h"
+
+namespace Kubuntu {
+
+/** Adds \p count hits and \p nsecs nanoseconds to \p counter. Lock-free. */
+KUBUNTU_TESTS_EXPORT void recordStatistics(Statistics::Counter counter,
+                                           quint64 count = 1, quint64 nsecs = 0);
+
+} // namespace Kubuntu
+
+#endif // L10N_STATISTICS_P_H
@@ -0,0 +1,111 @@
+/*
+  Copyright (C) 2015 Harald Sitter <sitter@kde.org>
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) version 3, or any
+  later version accepted by the membership of KDE e.V. (or its
+  successor approved by the membership of KDE e.V.), which shall
+  act as a proxy defined in Section 6 of version 3 of the license.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "l10n_stringtable_p.h"
+
+#include <QHash>
+#include <QReadLocker>
+#include <QReadWriteLock>
+#include <QVector>
+#include <QWriteLocker>
+
+namespace Kubuntu {
+
+struct StringTableData
+{
+    StringTableData()
+    {
+        strings.append(QString());
+        ids.insert(QString(), StringTable::EmptyId);
+    }
+
+    QReadWriteLock lock;
+    QHash<QString, quint32> ids;
+    QVector<QString> strings;
+    // Key is (prefix id << 32 | code id).
+    QHash<quint64, QString> packageNames;
+};
+
+Q_GLOBAL_STATIC(StringTableData, s_stringTable)
+
+quint32 StringTable::intern(const QString &string)
+{
+    if (string.isEmpty())
+        return EmptyId;
+
+    StringTableData *table = s_stringTable();
+    {
+        QReadLocker locker(&table->lock);
+        const QHash<QString, quint32>::const_iterator it = table->ids.constFind(string);
+        if (it != table->ids.constEnd())
+            return it.value();
+    }
+
+    QWriteLocker locker(&table->lock);
+    // Another thread may have been quicker.
+    const QHash<QString, quint32>::const_iterator it = table->ids.constFind(string);
+    if (it != table->ids.constEnd())
+        return it.value();
+    const quint32 id = table->strings.size();
+    table->strings.append(string);
+    table->ids.insert(string, id);
+    return id;
+}
+
+quint32 StringTable::id(const QString &string)
+{
+    StringTableData *table = s_stringTable();
+    QReadLocker locker(&table->lock);
+    return table->ids.value(string, EmptyId);
+}
+
+QString StringTable::string(quint32 id)
+{
+    StringTableData *table = s_stringTable();
+    QReadLocker locker(&table->lock);
+    return table->strings.value(id);
+}
+
+QString StringTable::packageName(quint32 prefixId, quint32 codeId)
+{
+    StringTableData *table = s_stringTable();
+    const quint64 key = (quint64(prefixId) << 32) | codeId;
+    {
+        QReadLocker locker(&table->lock);
+        const QHash<quint64, QString>::const_iterator it = table->packageNames.constFind(key);
+        if (it != table->packageNames.constEnd())
+            return it.value();
+    }
+
+    QWriteLocker locker(&table->lock);
+    QString &name = table->packageNames[key];
+    if (name.isNull())
+        name = table->strings.value(prefixId) + table->strings.value(codeId);
+    return name;
+}
+
+int StringTable::count()
+{
+    StringTableData *table = s_stringTable();
+    QReadLocker locker(&table->lock);
+    return table->strings.size();
+}
+
+} // namespace Kubuntu
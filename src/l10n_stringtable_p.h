@@ -0,0 +1,72 @@
+/*
+  Copyright (C) 2015 Harald Sitter <sitter@kde.org>
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) version 3, or any
+  later version accepted by the membership of KDE e.V. (or its
+  successor approved by the membership of KDE e.V.), which shall
+  act as a proxy defined in Section 6 of version 3 of the license.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef L10N_STRINGTABLE_P_H
+#define L10N_STRINGTABLE_P_H
+
+#include "export.h"
+
+#include <QString>
+
+namespace Kubuntu {
+
+/**
+ * Process-wide table of interned strings.
+ *
+ * Language codes and pkg_depends prefixes and triggers form a small vocabulary
+ * that is repeated by every Language and every rule. Interning stores each
+ * string once and identifies it by a compact id, so comparisons are integer
+ * compares and copies share one allocation.
+ *
+ * Package names composed of an interned prefix and an interned language code
+ * are cached as well, evaluating support repeatedly does not build the same
+ * names over and over.
+ *
+ * Entries are never removed, the vocabulary is bounded by pkg_depends and
+ * the known languages. All functions are thread-safe.
+ */
+class KUBUNTU_TESTS_EXPORT StringTable
+{
+public:
+    /** Id of the empty string, never used for anything else. */
+    enum { EmptyId = 0 };
+
+    /** \returns the id of \p string, adding it to the table if necessary */
+    static quint32 intern(const QString &string);
+
+    /** \returns the id of \p string, EmptyId if it was not interned */
+    static quint32 id(const QString &string);
+
+    /** \returns the string of \p id, sharing the table's copy */
+    static QString string(quint32 id);
+
+    /**
+     * \returns \p prefixId followed by \p codeId (e.g. kde-l10n- and de),
+     * sharing the table's copy once the name was composed before
+     */
+    static QString packageName(quint32 prefixId, quint32 codeId);
+
+    /** \returns number of interned strings, including the empty one */
+    static int count();
+};
+
+} // namespace Kubuntu
+
+#endif // L10N_STRINGTABLE_P_H
@@ -0,0 +1,177 @@
+/*
+  Copyright (C) 2015 Harald Sitter <sitter@kde.org>
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) version 3, or any
+  later version accepted by the membership of KDE e.V. (or its
+  successor approved by the membership of KDE e.V.), which shall
+  act as a proxy defined in Section 6 of version 3 of the license.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "l10n_systemlocales_p.h"
+
+#include <QFile>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QProcess>
+
+#include "l10n_debug_p.h"
+#include "l10n_sharedcache_p.h"
+
+namespace Kubuntu {
+
+struct SystemLocalesCache
+{
+    SystemLocalesCache() : availableValid(false), supportedValid(false) {}
+
+    QMutex mutex;
+    bool availableValid;
+    QSet<QString> available;
+    bool supportedValid;
+    QString supportedPath;
+    QSet<QString> supported;
+};
+
+Q_GLOBAL_STATIC(SystemLocalesCache, s_cache)
+
+static QSet<QString> runLocale()
+{
+    ScopedTimer timer(KUBUNTU_L10N_LOCALE(), "locale query", Statistics::LocaleQueries);
+    recordStatistics(Statistics::LocaleQueries);
+
+    QSet<QString> locales;
+    QProcess process;
+    process.start(QLatin1String("locale"), QStringList() << QLatin1String("-a"));
+    bool finished = process.waitForFinished(30 * 1000); // If locale takes more than 30 secs something is very wrong
+    if (!finished || process.exitStatus() != QProcess::NormalExit || process.exitCode() != 0) {
+        qCWarning(KUBUNTU_L10N_LOCALE) << "locale -a failed";
+        return locales;
+    }
+
+    while (process.canReadLine())
+        locales.insert(SystemLocales::normalized(QString::fromLocal8Bit(process.readLine()).trimmed()));
+    return locales;
+}
+
+// locale -a lists the archive as well as any locale directories.
+static QSet<QString> queryAvailable()
+{
+    if (!SharedCache::isEnabled())
+        return runLocale();
+
+    const QString name = QLatin1String("locales");
+    const QByteArray key = SharedCache::sourceKey(QStringList()
+                                                  << QLatin1String("/usr/lib/locale/locale-archive")
+                                                  << QLatin1String("/usr/lib/locale"));
+    const SharedCache::FilePtr file = SharedCache::open(name, key);
+    if (file) {
+        const QString payload = QString::fromUtf8(reinterpret_cast<const char *>(file->data()),
+                                                  file->size());
+        return payload.split(QLatin1Char('\n'), QString::SkipEmptyParts).toSet();
+    }
+
+    const QSet<QString> locales = runLocale();
+    if (!locales.isEmpty()) {
+        QStringList names = locales.toList();
+        names.sort();
+        SharedCache::write(name, key, names.join(QLatin1Char('\n')).toUtf8());
+    }
+    return locales;
+}
+
+static QSet<QString> readSupported(const QString &filePath)
+{
+    QSet<QString> locales;
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+        return locales;
+
+    // Lines are "<locale> <charset>", e.g. de_AT.UTF-8 UTF-8. We only
+    // support UTF-8.
+    while (!file.atEnd()) {
+        const QList<QByteArray> fields = file.readLine().simplified().split(' ');
+        if (fields.size() == 2 && fields.at(1) == "UTF-8")
+            locales.insert(SystemLocales::normalized(QString::fromLatin1(fields.at(0))));
+    }
+    return locales;
+}
+
+bool SystemLocales::isAvailable(const QString &locale)
+{
+    SystemLocalesCache *cache = s_cache();
+    QMutexLocker locker(&cache->mutex);
+    if (!cache->availableValid) {
+        cache->available = queryAvailable();
+        cache->availableValid = true;
+    }
+    return cache->available.contains(normalized(locale));
+}
+
+bool SystemLocales::isSupported(const QString &locale)
+{
+    SystemLocalesCache *cache = s_cache();
+    QMutexLocker locker(&cache->mutex);
+    if (!cache->supportedValid) {
+        cache->supported = readSupported(cache->supportedPath.isEmpty()
+                                         ? QLatin1String("/usr/share/i18n/SUPPORTED")
+                                         : cache->supportedPath);
+        cache->supportedValid = true;
+    }
+    return cache->supported.contains(normalized(locale));
+}
+
+void SystemLocales::invalidate()
+{
+    SystemLocalesCache *cache = s_cache();
+    QMutexLocker locker(&cache->mutex);
+    cache->availableValid = false;
+    cache->available.clear();
+}
+
+void SystemLocales::setAvailable(const QStringList &locales)
+{
+    SystemLocalesCache *cache = s_cache();
+    QMutexLocker locker(&cache->mutex);
+    cache->available.clear();
+    foreach (const QString &locale, locales)
+        cache->available.insert(normalized(locale));
+    cache->availableValid = true;
+}
+
+void SystemLocales::setSupportedPath(const QString &filePath)
+{
+    SystemLocalesCache *cache = s_cache();
+    QMutexLocker locker(&cache->mutex);
+    cache->supportedPath = filePath;
+    cache->supportedValid = false;
+    cache->supported.clear();
+}
+
+QString SystemLocales::normalized(const QString &locale)
+{
+    // We need to split the encoding from the locale as there's different
+    // formats floating around as supported (e.g. utf-8 vs. utf8)
+    // Also we only support utf-8 anyway, so it doesn't matter much as we assume
+    // it is always supported on Kubuntu systems.
+    // The modifier follows the encoding and names a different locale
+    // (ca_ES@valencia is not ca_ES), so it must stay.
+    QString normalized = locale.toLower();
+    const int dot = normalized.indexOf(QLatin1Char('.'));
+    if (dot >= 0) {
+        const int at = normalized.indexOf(QLatin1Char('@'), dot);
+        normalized.remove(dot, (at >= 0 ? at : normalized.size()) - dot);
+    }
+    return normalized;
+}
+
+} // namespace Kubuntu
@@ -0,0 +1,67 @@
+/*
+  Copyright (C) 2015 Harald Sitter <sitter@kde.org>
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) version 3, or any
+  later version accepted by the membership of KDE e.V. (or its
+  successor approved by the membership of KDE e.V.), which shall
+  act as a proxy defined in Section 6 of version 3 of the license.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef L10N_SYSTEMLOCALES_P_H
+#define L10N_SYSTEMLOCALES_P_H
+
+#include "export.h"
+
+#include <QSet>
+#include <QString>
+#include <QStringList>
+
+namespace Kubuntu {
+
+/**
+ * Process-wide cache of the locales generated on the system (locale -a) and
+ * the locales the system is able to generate (SUPPORTED of the locales
+ * package). Either is only queried once until invalidated.
+ *
+ * Locale names are compared in normalized form, so that for example
+ * de_AT.UTF-8 and de_AT.utf8 are the same locale.
+ */
+class KUBUNTU_TESTS_EXPORT SystemLocales
+{
+public:
+    /** \returns \c true if \p locale is generated */
+    static bool isAvailable(const QString &locale);
+
+    /** \returns \c true if \p locale can be generated as UTF-8 */
+    static bool isSupported(const QString &locale);
+
+    /** Drops the cached locale -a result, e.g. after generating locales. */
+    static void invalidate();
+
+    /**
+     * Overrides the available locales instead of querying locale -a, e.g.
+     * for tests. invalidate() restores querying.
+     */
+    static void setAvailable(const QStringList &locales);
+
+    /** Overrides the SUPPORTED file. An empty path restores the default. */
+    static void setSupportedPath(const QString &filePath);
+
+    /** \returns \p locale in lower case without encoding, e.g. ca_es@valencia */
+    static QString normalized(const QString &locale);
+};
+
+} // namespace Kubuntu
+
+#endif // L10N_SYSTEMLOCALES_P_H
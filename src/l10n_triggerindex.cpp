@@ -0,0 +1,138 @@
+/*
+  Copyright (C) 2015 Harald Sitter <sitter@kde.org>
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) version 3, or any
+  later version accepted by the membership of KDE e.V. (or its
+  successor approved by the membership of KDE e.V.), which shall
+  act as a proxy defined in Section 6 of version 3 of the license.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "l10n_triggerindex.h"
+
+#include <QHash>
+#include <QStringBuilder>
+
+#include "l10n_language.h"
+#include "l10n_pkgdepends_p.h"
+
+namespace Kubuntu {
+
+struct TriggerEntry
+{
+    /** Packages and prefixes for all languages. */
+    QStringList common;
+    /** Packages and prefixes per Ubuntu package code. */
+    QHash<QString, QStringList> languages;
+};
+
+class TriggerIndexPrivate
+{
+public:
+    TriggerIndexPrivate(const PkgDepends::Ptr &pkgDepends);
+
+    bool valid;
+    QHash<QString, TriggerEntry> triggers;
+};
+
+TriggerIndexPrivate::TriggerIndexPrivate(const PkgDepends::Ptr &pkgDepends)
+    : valid(pkgDepends->isValid())
+{
+    foreach (const PkgDependsRule &rule, pkgDepends->rules()) {
+        if (rule.trigger.isEmpty()) // Unconditional, not a trigger.
+            continue;
+        TriggerEntry &entry = triggers[rule.trigger];
+        QStringList &list = rule.language.isEmpty() ? entry.common : entry.languages[rule.language];
+        if (!list.contains(rule.package))
+            list.append(rule.package);
+    }
+}
+
+TriggerIndex::TriggerIndex()
+    : d_ptr(new TriggerIndexPrivate(PkgDepends::system()))
+{
+}
+
+TriggerIndex::TriggerIndex(const QString &pkgDependsPath)
+    : d_ptr(new TriggerIndexPrivate(PkgDepends::fromFile(pkgDependsPath)))
+{
+}
+
+TriggerIndex::~TriggerIndex()
+{
+}
+
+bool TriggerIndex::isValid() const
+{
+    Q_D(const TriggerIndex);
+    return d->valid;
+}
+
+bool TriggerIndex::isTrigger(const QString &packageName) const
+{
+    Q_D(const TriggerIndex);
+    return d->triggers.contains(packageName);
+}
+
+QStringList TriggerIndex::triggers() const
+{
+    Q_D(const TriggerIndex);
+    return d->triggers.keys();
+}
+
+bool TriggerIndex::affectsAllLanguages(const QString &trigger) const
+{
+    Q_D(const TriggerIndex);
+    return !d->triggers.value(trigger).common.isEmpty();
+}
+
+QStringList TriggerIndex::languages(const QString &trigger) const
+{
+    Q_D(const TriggerIndex);
+    return d->triggers.value(trigger).languages.keys();
+}
+
+QStringList TriggerIndex::prefixes(const QString &trigger, const QString &ubuntuPackageCode) const
+{
+    Q_D(const TriggerIndex);
+    QHash<QString, TriggerEntry>::const_iterator it = d->triggers.constFind(trigger);
+    if (it == d->triggers.constEnd())
+        return QStringList();
+    return it->common + it->languages.value(ubuntuPackageCode);
+}
+
+QStringList TriggerIndex::packages(const QString &trigger, const QString &kdeLanguageCode) const
+{
+    const QString kdePackageCode = Language::kdePackageCodeForKdeLanguageCode(kdeLanguageCode);
+    const QString ubuntuPackageCode = Language::ubuntuPackageCodeForKdeCode(kdeLanguageCode);
+
+    QStringList packages;
+    foreach (const QString &prefix, prefixes(trigger, ubuntuPackageCode)) {
+        // Same distinction as in Language::isSupportComplete; per-language
+        // prefixes get both codes appended, meta packages are used as-is.
+        if (!prefix.endsWith(QLatin1Char('-'))) {
+            if (!packages.contains(prefix))
+                packages.append(prefix);
+            continue;
+        }
+        const QString kdePackage = prefix % kdePackageCode;
+        if (!packages.contains(kdePackage))
+            packages.append(kdePackage);
+        const QString ubuntuPackage = prefix % ubuntuPackageCode;
+        if (!packages.contains(ubuntuPackage))
+            packages.append(ubuntuPackage);
+    }
+    return packages;
+}
+
+} // namespace Kubuntu
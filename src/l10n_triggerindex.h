@@ -0,0 +1,107 @@
+/*
+  Copyright (C) 2015 Harald Sitter <sitter@kde.org>
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) version 3, or any
+  later version accepted by the membership of KDE e.V. (or its
+  successor approved by the membership of KDE e.V.), which shall
+  act as a proxy defined in Section 6 of version 3 of the license.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef KUBUNTU_L10N_TRIGGERINDEX_H
+#define KUBUNTU_L10N_TRIGGERINDEX_H
+
+#include "export.h"
+
+#include <QScopedPointer>
+#include <QStringList>
+
+namespace Kubuntu {
+
+class TriggerIndexPrivate;
+
+/**
+ * \brief Reverse index of trigger packages to the language support they imply.
+ *
+ * Language support depends in part on which applications are installed, for
+ * example firefox requires firefox-locale-xx to be installed for a complete
+ * localization. The TriggerIndex answers which languages and packages an
+ * application (the trigger) implies without evaluating any Language.
+ *
+ * \code
+ * TriggerIndex index;
+ * if (index.isTrigger("firefox"))
+ *     index.packages("firefox", "de"); // firefox-locale-de
+ * \endcode
+ *
+ * All lookups are constant time. Availability or installation state of the
+ * packages is not checked.
+ */
+class KUBUNTU_EXPORT TriggerIndex
+{
+public:
+    /** Constructs an index of the system's language-selector pkg_depends. */
+    TriggerIndex();
+
+    /**
+     * Constructs an index from a pkg_depends file.
+     * \param pkgDependsPath path of a file in language-selector's pkg_depends format.
+     */
+    explicit TriggerIndex(const QString &pkgDependsPath);
+
+    /** Destructor. */
+    ~TriggerIndex();
+
+    /** \returns \c true if the pkg_depends file could be read */
+    bool isValid() const;
+
+    /** \returns \c true if installing \p packageName implies language packages */
+    bool isTrigger(const QString &packageName) const;
+
+    /** \returns names of all trigger packages */
+    QStringList triggers() const;
+
+    /** \returns \c true if \p trigger implies packages for every language */
+    bool affectsAllLanguages(const QString &trigger) const;
+
+    /**
+     * \returns Ubuntu package codes of all languages \p trigger has language
+     * specific rules for. Does not include languages only affected by rules
+     * for all languages. \see affectsAllLanguages
+     */
+    QStringList languages(const QString &trigger) const;
+
+    /**
+     * \returns the package names and prefixes (e.g. firefox-locale-) implied by
+     * \p trigger for the language with the Ubuntu package code
+     * \p ubuntuPackageCode, including the ones for all languages.
+     */
+    QStringList prefixes(const QString &trigger, const QString &ubuntuPackageCode) const;
+
+    /**
+     * \returns the package names implied by \p trigger for a language, i.e.
+     * prefixes() with the language's package codes appended.
+     * \param trigger the trigger package
+     * \param kdeLanguageCode the KDE language code (e.g. pt_BR)
+     */
+    QStringList packages(const QString &trigger, const QString &kdeLanguageCode) const;
+
+private:
+    const QScopedPointer<TriggerIndexPrivate> d_ptr;
+    Q_DECLARE_PRIVATE(TriggerIndex)
+    Q_DISABLE_COPY(TriggerIndex)
+};
+
+} // namespace Kubuntu
+
+#endif // KUBUNTU_L10N_TRIGGERINDEX_H
@@ -0,0 +1,211 @@
+/*
+  Copyright (C) 2015 Harald Sitter <sitter@kde.org>
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) version 3, or any
+  later version accepted by the membership of KDE e.V. (or its
+  successor approved by the membership of KDE e.V.), which shall
+  act as a proxy defined in Section 6 of version 3 of the license.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMap>
+#include <QTextStream>
+
+#include "l10n_internal.h"
+#include "l10n_language.h"
+#include "l10n_languagecollection.h"
+
+using namespace Kubuntu;
+using namespace Kubuntu::Internal;
+
+enum ExitCode {
+    ExitComplete = 0,
+    ExitIncomplete = 1,
+    ExitError = 2
+};
+
+static int fail(const QString &message)
+{
+    QTextStream(stderr) << message << endl;
+    return ExitError;
+}
+
+static double msecs(QElapsedTimer &timer)
+{
+    return timer.nsecsElapsed() / 1000000.0;
+}
+
+// Loads the package state of the system installed in root: installed
+// packages from dpkg, available ones from the APT lists.
+static bool loadRoot(FixturePackages *packages, const QString &root)
+{
+    if (!packages->loadControlFile(root + defaultDpkgStatusPath()))
+        return false;
+
+    const QDir lists(root + QLatin1String("/var/lib/apt/lists"));
+    foreach (const QString &list, lists.entryList(QStringList() << QLatin1String("*_Packages"), QDir::Files))
+        packages->loadControlFile(lists.filePath(list));
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    QElapsedTimer totalTimer;
+    totalTimer.start();
+
+    QCoreApplication app(argc, argv);
+    app.setApplicationName(QLatin1String("kubuntu-l10n-audit"));
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QLatin1String(
+        "Audits the language support of the system and prints the result as JSON.\n"
+        "Exits with 0 if support is complete, 1 if packages are missing and 2 on errors, "
+        "such as unknown languages or unreadable rules."));
+    parser.addHelpOption();
+    parser.addPositionalArgument(QLatin1String("languages"),
+                                 QLatin1String("KDE language codes to audit; all available languages if omitted."),
+                                 QLatin1String("[languages...]"));
+    QCommandLineOption rootOption(QLatin1String("root"),
+                                  QLatin1String("Audit the system installed in <directory> offline, "
+                                                "reading dpkg and APT list files instead of the APT cache."),
+                                  QLatin1String("directory"));
+    QCommandLineOption fixtureOption(QLatin1String("fixture"),
+                                     QLatin1String("Read package states from <file> instead of the APT cache, "
+                                                   "one package per line optionally followed by 'installed'."),
+                                     QLatin1String("file"));
+    QCommandLineOption pkgDependsOption(QLatin1String("pkg-depends"),
+                                        QLatin1String("Read language-selector rules from <file>."),
+                                        QLatin1String("file"));
+    QCommandLineOption compactOption(QLatin1String("compact"),
+                                     QLatin1String("Print the JSON document on a single line."));
+    parser.addOption(rootOption);
+    parser.addOption(fixtureOption);
+    parser.addOption(pkgDependsOption);
+    parser.addOption(compactOption);
+    parser.process(app);
+
+    if (parser.isSet(rootOption) && parser.isSet(fixtureOption))
+        return fail(QLatin1String("--root and --fixture are mutually exclusive"));
+
+    // Setup: pick the package state source and the rules.
+    QElapsedTimer timer;
+    timer.start();
+
+    FixturePackages packages;
+    if (parser.isSet(rootOption)) {
+        const QString root = QDir(parser.value(rootOption)).absolutePath();
+        if (!loadRoot(&packages, root))
+            return fail(QLatin1String("Could not read the dpkg status of ") + root);
+        setDpkgStatusPath(root + defaultDpkgStatusPath());
+        setPkgDependsPath(root + defaultPkgDependsPath());
+        packages.install();
+    } else if (parser.isSet(fixtureOption)) {
+        if (!packages.load(parser.value(fixtureOption)))
+            return fail(QLatin1String("Could not read ") + parser.value(fixtureOption));
+        packages.install();
+    }
+    if (parser.isSet(pkgDependsOption))
+        setPkgDependsPath(parser.value(pkgDependsOption));
+
+    // Errors do not stop the audit, but it must not report success.
+    QStringList errors;
+    const bool pkgDependsValid = isPkgDependsValid();
+    if (!pkgDependsValid)
+        errors << QLatin1String("Could not read the language-selector rules from ") + pkgDependsPath();
+    const double setupTime = msecs(timer);
+
+    timer.restart();
+    LanguageCollection collection;
+    if (!collection.isValid())
+        return fail(QLatin1String("Could not initialize the package backend"));
+    const double initTime = msecs(timer);
+
+    // Enumerate, or only look up what was asked for.
+    timer.restart();
+    QSet<Language *> languages;
+    if (parser.positionalArguments().isEmpty()) {
+        languages = collection.languages();
+    } else {
+        foreach (const QString &code, parser.positionalArguments()) {
+            if (!collection.languageInfo(code).isValid()) {
+                errors << QLatin1String("Unknown language ") + code;
+                continue;
+            }
+            languages.insert(collection.language(code));
+        }
+    }
+    const double enumerateTime = msecs(timer);
+
+    // All Languages in one batched, parallel pass.
+    timer.restart();
+    if (!languages.isEmpty()) {
+        QEventLoop loop;
+        QObject::connect(&collection, SIGNAL(supportChecked(QSet<Kubuntu::Language*>)),
+                         &loop, SLOT(quit()));
+        collection.checkSupport(languages);
+        loop.exec();
+    }
+    const double checkTime = msecs(timer);
+
+    QMap<QString, QJsonObject> results; // Sorted output.
+    bool complete = true;
+    foreach (Language *language, languages) {
+        QStringList missing = language->missingPackages();
+        missing.sort();
+        QJsonObject result;
+        result.insert(QLatin1String("language"), language->kdeLanguageCode());
+        result.insert(QLatin1String("complete"), missing.isEmpty());
+        result.insert(QLatin1String("missingPackages"), QJsonArray::fromStringList(missing));
+        results.insert(language->kdeLanguageCode(), result);
+        complete = complete && missing.isEmpty();
+    }
+
+    QJsonArray languageArray;
+    foreach (const QJsonObject &result, results)
+        languageArray.append(result);
+
+    QJsonObject timings;
+    timings.insert(QLatin1String("setup"), setupTime);
+    timings.insert(QLatin1String("init"), initTime);
+    timings.insert(QLatin1String("enumerate"), enumerateTime);
+    timings.insert(QLatin1String("check"), checkTime);
+    timings.insert(QLatin1String("total"), msecs(totalTimer));
+
+    QJsonObject document;
+    document.insert(QLatin1String("complete"), complete);
+    document.insert(QLatin1String("pkgDepends"), pkgDependsPath());
+    // Without rules nothing is ever missing, see errors.
+    document.insert(QLatin1String("pkgDependsValid"), pkgDependsValid);
+    document.insert(QLatin1String("languages"), languageArray);
+    document.insert(QLatin1String("errors"), QJsonArray::fromStringList(errors));
+    document.insert(QLatin1String("timings"), timings);
+
+    QTextStream(stdout) << QJsonDocument(document).toJson(parser.isSet(compactOption)
+                                                           ? QJsonDocument::Compact
+                                                           : QJsonDocument::Indented);
+
+    foreach (const QString &error, errors)
+        QTextStream(stderr) << error << endl;
+
+    if (!errors.isEmpty())
+        return ExitError;
+    return complete ? ExitComplete : ExitIncomplete;
+}